@@ -0,0 +1,92 @@
+// Batch Sort
+//
+// Sorts many samples at once on one thread pool, reusing the sample buffers
+// from batch to batch.
+
+#ifndef BATCHSORT_H
+#define BATCHSORT_H
+
+#include <cstddef>
+#include <vector>
+#include "counting.h"
+#include "threadpool.h"
+
+// Samples at or above this size are sorted one at a time with the parallel sort
+const size_t BATCH_PARALLEL_MIN_SIZE = 1 << 16;
+
+/* Sorts a copy of every sample in a batch. Small samples are spread across the
+ pool one sample per task, with the copy made on the task so it is still in
+ cache when the sort starts. Samples of at least parallel_min_size elements
+ are then sorted one at a time by parallel_sort, which gets the whole pool;
+ without a parallel_sort they are handled like the small ones. Each sample is
+ counted into its own Counter, and Sorted() and Counts() are in input order.
+ The buffers keep their capacity, so batches of similar samples allocate
+ nothing after the first. */
+template <class Counter>
+class BatchSorter {
+public:
+   typedef void (*SortFunction)(std::vector<int>* numbers, Counter& counter);
+   typedef void (*ParallelSortFunction)(std::vector<int>* numbers, Counter& counter, ThreadPool& pool);
+
+   // num_threads of 0 uses one worker per hardware thread
+   explicit BatchSorter(int num_threads = 0, size_t parallel_min_size = BATCH_PARALLEL_MIN_SIZE)
+      : parallel_min_size_(parallel_min_size), pool_(num_threads), size_(0) {}
+
+   BatchSorter(const BatchSorter&) = delete;
+   BatchSorter& operator=(const BatchSorter&) = delete;
+
+   // Sort the batch, replacing the results of the previous one
+   void Sort(const std::vector<std::vector<int>>& inputs, SortFunction sort,
+             ParallelSortFunction parallel_sort = nullptr) {
+      size_ = inputs.size();
+      if (buffers_.size() < size_) {
+         buffers_.resize(size_);
+      }
+      counts_.assign(size_, Counter());
+
+      {
+         TaskGroup group(pool_);  // One task per small sample
+         for (size_t index = 0; index < size_; ++index) {
+            if (IsParallel(inputs[index], parallel_sort)) {
+               continue;
+            }
+            const std::vector<int>* input = &inputs[index];
+            std::vector<int>* buffer = &buffers_[index];
+            Counter* counts = &counts_[index];
+            group.Run([input, buffer, counts, sort] {
+               Counter counter;  // Local, so tasks never write to neighbouring counters
+               buffer->assign(input->begin(), input->end());
+               sort(buffer, counter);
+               *counts = counter;
+            });
+         }
+         group.Wait();
+      }
+
+      for (size_t index = 0; index < size_; ++index) {
+         if (IsParallel(inputs[index], parallel_sort)) {
+            buffers_[index].assign(inputs[index].begin(), inputs[index].end());
+            parallel_sort(&buffers_[index], counts_[index], pool_);
+         }
+      }
+   }
+
+   size_t Size() const { return size_; }
+   const std::vector<int>& Sorted(size_t index) const { return buffers_[index]; }
+   const Counter& Counts(size_t index) const { return counts_[index]; }
+
+   ThreadPool& Pool() { return pool_; }
+
+private:
+   bool IsParallel(const std::vector<int>& input, ParallelSortFunction parallel_sort) const {
+      return parallel_sort != nullptr && input.size() >= parallel_min_size_;
+   }
+
+   size_t parallel_min_size_;
+   ThreadPool pool_;
+   std::vector<std::vector<int>> buffers_;  // Reused by later batches, never shrunk
+   std::vector<Counter> counts_;
+   size_t size_;
+};
+
+#endif
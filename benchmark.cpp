@@ -0,0 +1,128 @@
+// Benchmark
+//
+// Repeated, warmed-up timing of a sort with summary statistics.
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/* Summarize the timed runs. p95 uses the nearest-rank method and stddev is
+ the sample standard deviation. */
+static void ComputeStats(TimingStats& stats) {
+   std::vector<double> sorted = stats.runs;
+   size_t count = sorted.size();
+   double sum = 0;
+   double squares = 0;
+
+   if (count == 0) {
+      return;
+   }
+
+   std::sort(sorted.begin(), sorted.end());
+   stats.min = sorted[0];
+   stats.median = count % 2 == 1 ? sorted[count / 2]
+                                  : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+   stats.p95 = sorted[(size_t)std::ceil(0.95 * count) - 1];
+
+   for (double run : sorted) {
+      sum += run;
+   }
+   stats.mean = sum / count;
+
+   for (double run : sorted) {
+      squares += (run - stats.mean) * (run - stats.mean);
+   }
+   stats.stddev = count > 1 ? std::sqrt(squares / (count - 1)) : 0;
+}
+
+TimingStats TimeSort(const std::vector<int>& input, std::vector<int>& work,
+                     const std::function<void(std::vector<int>*)>& sort,
+                     const BenchmarkOptions& options) {
+   TimingStats stats;
+
+   for (int run = 0; run < options.warmup; ++run) {
+      work = input;
+      sort(&work);
+   }
+
+   for (int run = 0; run < options.repetitions; ++run) {
+      work = input;  // Restore the unsorted input, not timed
+
+      auto start = std::chrono::steady_clock::now();
+      sort(&work);
+      auto end = std::chrono::steady_clock::now();
+
+      stats.runs.push_back(std::chrono::duration<double>(end - start).count());
+   }
+
+   ComputeStats(stats);
+   return stats;
+}
+
+TimingStats TimeSortBatch(const std::vector<std::vector<int>>& inputs,
+                          std::vector<std::vector<int>>& work,
+                          const std::function<void(std::vector<int>*)>& sort,
+                          const BenchmarkOptions& options) {
+   TimingStats stats;
+
+   for (int run = 0; run < options.warmup; ++run) {
+      work = inputs;
+      for (std::vector<int>& numbers : work) {
+         sort(&numbers);
+      }
+   }
+
+   for (int run = 0; run < options.repetitions; ++run) {
+      work = inputs;  // Restore the unsorted inputs, not timed
+
+      auto start = std::chrono::steady_clock::now();
+      for (std::vector<int>& numbers : work) {
+         sort(&numbers);
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      stats.runs.push_back(std::chrono::duration<double>(end - start).count());
+   }
+
+   ComputeStats(stats);
+   return stats;
+}
+
+PerfReading CountSortEvents(const std::vector<int>& input, std::vector<int>& work,
+                            const std::function<void(std::vector<int>*)>& sort,
+                            PerfCounters& counters, int repetitions) {
+   PerfReading reading;
+
+   counters.Reset();
+   for (int run = 0; run < repetitions; ++run) {
+      work = input;  // Restore the unsorted input, not counted
+
+      counters.Start();
+      sort(&work);
+      counters.Stop();
+   }
+
+   reading = counters.Read();
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      reading.values[event] = repetitions > 0 ? reading.values[event] / repetitions : 0;
+   }
+   return reading;
+}
+
+bool PinToCpu(int cpu) {
+#ifdef __linux__
+   cpu_set_t cpus;
+   CPU_ZERO(&cpus);
+   CPU_SET(cpu, &cpus);
+   return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+   (void)cpu;
+   return false;
+#endif
+}
@@ -0,0 +1,51 @@
+// Benchmark
+//
+// Repeated, warmed-up timing of a sort with summary statistics.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <vector>
+#include "perfcounters.h"
+
+struct BenchmarkOptions {
+   int warmup = 0;        // Untimed runs before measuring
+   int repetitions = 1;   // Timed runs
+   int cpu = -1;          // CPU to pin the benchmark thread to, -1 leaves it unpinned
+};
+
+// Statistics over the timed runs, all in seconds
+struct TimingStats {
+   double min = 0;
+   double median = 0;
+   double p95 = 0;
+   double mean = 0;
+   double stddev = 0;
+   std::vector<double> runs;
+};
+
+/* Run sort options.repetitions times (after options.warmup untimed runs),
+ each time on a fresh copy of input in work. The copy is made outside the
+ timed region. Times come from std::chrono::steady_clock. */
+TimingStats TimeSort(const std::vector<int>& input, std::vector<int>& work,
+                     const std::function<void(std::vector<int>*)>& sort,
+                     const BenchmarkOptions& options);
+
+/* TimeSort over a batch: every timed run sorts a fresh copy of each input,
+ so sizes too small to time on their own still give a measurable run. */
+TimingStats TimeSortBatch(const std::vector<std::vector<int>>& inputs,
+                          std::vector<std::vector<int>>& work,
+                          const std::function<void(std::vector<int>*)>& sort,
+                          const BenchmarkOptions& options);
+
+/* Run sort repetitions times on fresh copies of input in work, with counters
+ enabled only around each sort call, and return the mean count per call */
+PerfReading CountSortEvents(const std::vector<int>& input, std::vector<int>& work,
+                            const std::function<void(std::vector<int>*)>& sort,
+                            PerfCounters& counters, int repetitions);
+
+// Pin the calling thread to one CPU, returns false if that is not possible
+bool PinToCpu(int cpu);
+
+#endif
@@ -0,0 +1,293 @@
+#include <iostream>       // for input/output streams (cout, cerr)
+#include <fstream>        // for file input/output (ifstream, ofstream)
+#include <sstream>        // for splitting comma-separated lists
+#include <string>         // for using string
+#include <vector>         // for using vector data structure
+#include <map>            // for the baseline results
+#include <climits>        // for INT_MAX and LLONG_MAX
+#include <cerrno>         // for errno and ERANGE
+#include <cmath>          // for isfinite
+#include <cstdlib>        // for strtoll and strtod
+#include "benchmark.h"     // include the timing harness
+#include "insertionsort.h" // include the insertion sorts
+#include "mergesort.h"     // include the merge sorts
+#include "quicksort.h"     // include the quick sorts
+#include "radixsort.h"     // include the radix sorts
+#include "selector.h"      // include the adaptive sort
+#include "workload.h"      // include the seeded sample generator
+
+using namespace std;          // use standard namespace
+
+// a sort run by the suite
+struct SuiteAlgorithm {
+    string name;                           // column name in the results matrix
+    void (*sort)(vector<int>*, NoCount&);  // the uninstrumented sort
+    bool quadratic_on_all;                 // O(n^2) on most inputs, skipped above --quadratic-max
+    bool quadratic_on_killer;              // O(n^2) on the killer distribution, skipped there above --quadratic-max
+};
+
+// every serial sort in the repo, in column order
+const SuiteAlgorithm SUITE_ALGORITHMS[] = {
+    {"InsertionSort", [](vector<int>* v, NoCount& c) { InsertionSort(v, c); }, true, true},
+    {"InsertionSortFast", [](vector<int>* v, NoCount& c) { InsertionSortFast(v, c); }, true, true},
+    {"MergeSort", [](vector<int>* v, NoCount& c) { MergeSort(v, c); }, false, false},
+    {"MergeSortBuffered", [](vector<int>* v, NoCount& c) { MergeSortBuffered(v, c); }, false, false},
+    {"MergeSortBottomUp", [](vector<int>* v, NoCount& c) { MergeSortBottomUp(v, c); }, false, false},
+    {"MergeSortNatural", [](vector<int>* v, NoCount& c) { MergeSortNatural(v, c); }, false, false},
+    {"MergeSortMultiway", [](vector<int>* v, NoCount& c) { MergeSortMultiway(v, c); }, false, false},
+    {"QuickSort", [](vector<int>* v, NoCount& c) { QuickSort(v, c); }, false, true},
+    {"QuickSortIntro", [](vector<int>* v, NoCount& c) { QuickSortIntro(v, c); }, false, false},
+    {"QuickSortBlock", [](vector<int>* v, NoCount& c) { QuickSortBlock(v, c); }, false, false},
+    {"RadixSort", [](vector<int>* v, NoCount& c) { RadixSort(v, c); }, false, false},
+    {"RadixSortInPlace", [](vector<int>* v, NoCount& c) { RadixSortInPlace(v, c); }, false, false},
+    {"AdaptiveSort", [](vector<int>* v, NoCount& c) { Sort(v, c); }, false, false},
+};
+
+// split a comma-separated list
+vector<string> SplitList(const string& value) {
+    vector<string> items;  // the list items in order
+    stringstream stream(value);
+    string item;
+    while (getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// parse a flag value as a whole number in [low, high]
+// returns false if it is not one, so a bad value is reported instead of aborting the program
+bool ParseNumber(const string& value, long long low, long long high, long long& number) {
+    char* end = nullptr;  // first character after the number
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > high) {
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
+// parse a flag value as a finite number that is not negative, false if it is not one
+bool ParseFraction(const string& value, double& number) {
+    char* end = nullptr;  // first character after the number
+    double parsed = strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !isfinite(parsed) || parsed < 0) {
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
+// read a results matrix written by an earlier run, keyed by "distribution,size,algorithm"
+map<string, double> ReadResults(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open file: " + filename);
+    }
+    map<string, double> results;
+    string line;
+    getline(file, line);
+    vector<string> header = SplitList(line);  // Distribution,Size, then one column per algorithm
+    while (getline(file, line)) {
+        vector<string> cells = SplitList(line);
+        for (size_t column = 2; column < cells.size() && column < header.size(); column++) {
+            if (!cells[column].empty()) {
+                results[cells[0] + "," + cells[1] + "," + header[column]] = stod(cells[column]);
+            }
+        }
+    }
+    return results;
+}
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be at least 2
+    // program name + results filename, followed by the optional flags
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <results.csv> [--sizes N,N,...] [--dists all|NAME,NAME,...] [--samples N]"
+             << " [--seed N] [--warmup N] [--reps N] [--pin CPU] [--quadratic-max N]"
+             << " [--baseline old.csv] [--tolerance FRACTION]" << endl; // print error message to standard error
+        return 1;  // return error code 1 indicating failure
+    }
+
+    string results_filename = argv[1];   // argv[1] is where the results matrix goes
+    vector<int> sizes = {1024, 8192, 65536};  // sample sizes swept
+    vector<Distribution> distributions;  // distributions swept, all of them by default
+    int num_samples = 4;                 // samples per distribution and size, timed together
+    uint64_t seed = 1;                   // the same seed sweeps the same inputs
+    int quadratic_max = 1 << 15;         // largest size a quadratic case is run at
+    string baseline_filename;            // optional results of an earlier revision to compare against
+    double tolerance = 0.10;             // slowdown against the baseline that counts as a regression
+    BenchmarkOptions options;            // warm-up runs, timed runs and CPU pinning
+    options.warmup = 1;
+    options.repetitions = 5;
+    for (int arg = 2; arg < argc; arg += 2) {
+        string flag = argv[arg];  // name of the flag
+        if (arg + 1 >= argc) {
+            cerr << "Error: Missing value for " << flag << endl; // every flag takes a value
+            return 1;  // return error code 1 indicating failure
+        }
+        string value = argv[arg + 1];  // value of the flag
+        long long number = 0;          // value of a numeric flag
+        bool numeric = flag == "--samples" || flag == "--warmup" || flag == "--reps" || flag == "--quadratic-max";  // counts, never negative
+        if ((numeric && !ParseNumber(value, 0, INT_MAX, number)) ||
+            (flag == "--seed" && !ParseNumber(value, 0, LLONG_MAX, number)) ||
+            (flag == "--pin" && !ParseNumber(value, -1, INT_MAX, number))) {
+            cerr << "Error: Invalid value for " << flag << ": " << value << endl; // not a number or out of range
+            return 1;  // return error code 1 indicating failure
+        }
+        if (flag == "--sizes") {
+            sizes.clear();
+            for (const string& size : SplitList(value)) {
+                if (!ParseNumber(size, 1, INT_MAX, number)) {
+                    cerr << "Error: --sizes must be positive whole numbers, not " << size << endl; // nothing to sort
+                    return 1;  // return error code 1 indicating failure
+                }
+                sizes.push_back(number);
+            }
+            if (sizes.empty()) {
+                cerr << "Error: Missing value for " << flag << endl; // an empty list sweeps nothing
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        else if (flag == "--dists") {
+            for (const string& name : SplitList(value)) {
+                Distribution distribution;
+                if (name == "all") {
+                    continue;  // the default
+                }
+                if (!ParseDistribution(name, distribution)) {
+                    cerr << "Error: Unknown distribution " << name << endl; // print error message for unknown distributions
+                    return 1;  // return error code 1 indicating failure
+                }
+                distributions.push_back(distribution);
+            }
+        }
+        else if (flag == "--samples") {
+            num_samples = number;
+        }
+        else if (flag == "--seed") {
+            seed = number;
+        }
+        else if (flag == "--warmup") {
+            options.warmup = number;
+        }
+        else if (flag == "--reps") {
+            options.repetitions = number;
+        }
+        else if (flag == "--pin") {
+            options.cpu = number;  // -1 leaves the thread unpinned
+        }
+        else if (flag == "--quadratic-max") {
+            quadratic_max = number;
+        }
+        else if (flag == "--baseline") {
+            baseline_filename = value;
+        }
+        else if (flag == "--tolerance") {
+            if (!ParseFraction(value, tolerance)) {
+                cerr << "Error: --tolerance must be a fraction that is not negative, not " << value << endl; // a slowdown of at least 0
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+    if (distributions.empty()) {
+        for (int dist = 0; dist < NUM_DISTRIBUTIONS; dist++) {
+            distributions.push_back((Distribution)dist);
+        }
+    }
+    if (options.repetitions < 1 || num_samples < 1) {
+        cerr << "Error: --reps and --samples must be at least 1" << endl; // need something to time
+        return 1;  // return error code 1 indicating failure
+    }
+
+    // pin to one CPU so runs are not migrated between cores mid-measurement
+    if (options.cpu >= 0 && !PinToCpu(options.cpu)) {
+        cerr << "Warning: Cannot pin to CPU " << options.cpu << endl; // keep going unpinned
+    }
+
+    // read the baseline before the sweep, so a bad file fails fast
+    map<string, double> baseline;
+    try {
+        if (!baseline_filename.empty()) {
+            baseline = ReadResults(baseline_filename);
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if the baseline cannot be read
+        return 1;  // return error code 1 indicating failure
+    }
+
+    ofstream results_file(results_filename);
+    if (!results_file.is_open()) {
+        cerr << "Error: Cannot open file " << results_filename << endl; // print error message if file cannot be opened
+        return 1;  // return error code 1 indicating failure
+    }
+
+    // header row, one column per algorithm
+    results_file << "Distribution,Size";
+    for (const SuiteAlgorithm& algorithm : SUITE_ALGORITHMS) {
+        results_file << "," << algorithm.name;
+    }
+    results_file << endl;
+
+    WorkloadOptions workload;          // default distribution parameters
+    int regressions = 0;               // cells slower than the baseline allows
+    vector<vector<int>> inputs;        // samples of the current distribution and size
+    vector<vector<int>> work;          // copies that are sorted, restored before every run
+    for (Distribution distribution : distributions) {
+        for (int size : sizes) {
+            // the killer takes O(n^2) to generate, so large ones are left out along with their row
+            if (distribution == DIST_KILLER && size > quadratic_max) {
+                continue;
+            }
+
+            inputs.resize(num_samples);
+            for (int index = 0; index < num_samples; index++) {
+                GenerateSample(distribution, size, SampleSeed(seed, index), workload, inputs[index]);
+            }
+
+            string row = string(DISTRIBUTION_NAMES[distribution]) + "," + to_string(size);  // the row key
+            results_file << row;
+            for (const SuiteAlgorithm& algorithm : SUITE_ALGORITHMS) {
+                results_file << ",";
+
+                // quadratic cases at large sizes would take the whole run, leave the cell empty
+                bool quadratic = algorithm.quadratic_on_all || (algorithm.quadratic_on_killer && distribution == DIST_KILLER);
+                if (quadratic && size > quadratic_max) {
+                    continue;
+                }
+
+                // median over the runs of one pass through every sample, reported per sample
+                TimingStats stats = TimeSortBatch(inputs, work, [&](vector<int>* numbers) {
+                    NoCount counter;
+                    algorithm.sort(numbers, counter);
+                }, options);
+                double per_sample = stats.median / num_samples;  // seconds to sort one sample
+                results_file << per_sample;
+
+                // compare against the baseline, if it has this cell
+                auto old = baseline.find(row + "," + algorithm.name);
+                if (old != baseline.end() && per_sample > old->second * (1 + tolerance)) {
+                    cerr << "Regression: " << row << "," << algorithm.name << " took " << per_sample
+                         << "s, baseline " << old->second << "s (+"
+                         << (int)((per_sample / old->second - 1) * 100 + 0.5) << "%)" << endl;
+                    regressions++;
+                }
+            }
+            results_file << endl;
+            cout << row << " done" << endl;  // progress, sweeps can take a while
+        }
+    }
+
+    // a non-zero exit code lets scripts stop on a regression
+    if (regressions > 0) {
+        cerr << regressions << " regression(s) against " << baseline_filename << endl;
+        return 2;  // return error code 2 indicating regressions
+    }
+
+    return 0;  // Return 0 :)
+}
@@ -0,0 +1,210 @@
+// Checksum
+//
+// 128-bit digest of int32 samples. The accumulate and scramble steps follow
+// XXH3: each 64-bit lane adds the product of the two 32-bit halves of its
+// keyed input and the unkeyed input of its neighbour lane.
+
+#include "checksum.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// xxHash primes
+const uint64_t PRIME32_1 = 0x9E3779B1ULL;
+const uint64_t PRIME32_2 = 0x85EBCA77ULL;
+const uint64_t PRIME32_3 = 0xC2B2AE3DULL;
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+/* Keys, the first 24 outputs of SplitMix64 from 0. Stripe n of a block is
+ keyed with KEYS[n..n+7], the scramble uses KEYS[16..23]. */
+alignas(32) static const uint64_t KEYS[DIGEST_BLOCK_STRIPES + DIGEST_LANES] = {
+   0xE220A8397B1DCDAFULL, 0x6E789E6AA1B965F4ULL, 0x06C45D188009454FULL,
+   0xF88BB8A8724C81ECULL, 0x1B39896A51A8749BULL, 0x53CB9F0C747EA2EAULL,
+   0x2C829ABE1F4532E1ULL, 0xC584133AC916AB3CULL, 0x3EE5789041C98AC3ULL,
+   0xF3B8488C368CB0A6ULL, 0x657EECDD3CB13D09ULL, 0xC2D326E0055BDEF6ULL,
+   0x8621A03FE0BBDB7BULL, 0x8E1F7555983AA92FULL, 0xB54E0F1600CC4D19ULL,
+   0x84BB3F97971D80ABULL, 0x7D29825C75521255ULL, 0xC3CF17102B7F7F86ULL,
+   0x3466E9A083914F64ULL, 0xD81A8D2B5A4485ACULL, 0xDB01602B100B9ED7ULL,
+   0xA9038A921825F10DULL, 0xEDF5F1D90DCA2F6AULL, 0x54496AD67BD2634CULL,
+};
+
+const uint64_t* const SCRAMBLE_KEYS = KEYS + DIGEST_BLOCK_STRIPES;
+
+/* Take one stripe of data into acc, keyed with keys[0..DIGEST_LANES-1]. Pairs
+ of ints are read as one little-endian 64-bit word, as the vector loads do. */
+static inline void Accumulate(uint64_t* acc, const int* data, const uint64_t* keys) {
+#if defined(__AVX2__)
+   for (int lane = 0; lane < DIGEST_LANES; lane += 4) {
+      __m256i value = _mm256_loadu_si256((const __m256i*)(data + 2 * lane));
+      __m256i keyed = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i*)(keys + lane)));
+      __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      __m256i sum = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(acc + lane)),
+                                     _mm256_add_epi64(product, swapped));
+      _mm256_storeu_si256((__m256i*)(acc + lane), sum);
+   }
+#elif defined(__SSE2__)
+   for (int lane = 0; lane < DIGEST_LANES; lane += 2) {
+      __m128i value = _mm_loadu_si128((const __m128i*)(data + 2 * lane));
+      __m128i keyed = _mm_xor_si128(value, _mm_loadu_si128((const __m128i*)(keys + lane)));
+      __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      __m128i sum = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(acc + lane)), _mm_add_epi64(product, swapped));
+      _mm_storeu_si128((__m128i*)(acc + lane), sum);
+   }
+#else
+   for (int lane = 0; lane < DIGEST_LANES; ++lane) {
+      uint64_t value = (uint64_t)(uint32_t)data[2 * lane] | (uint64_t)(uint32_t)data[2 * lane + 1] << 32;
+      uint64_t keyed = value ^ keys[lane];
+      acc[lane ^ 1] += value;
+      acc[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+   }
+#endif
+}
+
+// Spread the bits of every accumulator at the end of a block
+static inline void Scramble(uint64_t* acc) {
+   for (int lane = 0; lane < DIGEST_LANES; ++lane) {
+      uint64_t value = acc[lane];
+      value ^= value >> 47;
+      value ^= SCRAMBLE_KEYS[lane];
+      acc[lane] = value * PRIME32_1;
+   }
+}
+
+static inline uint64_t Fold(uint64_t a, uint64_t b) {
+   unsigned __int128 product = (unsigned __int128)a * b;
+   return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// Fold the accumulators into 64 bits
+static uint64_t Merge(const uint64_t* acc, const uint64_t* keys, uint64_t start) {
+   uint64_t hash = start;
+
+   for (int lane = 0; lane < DIGEST_LANES; lane += 2) {
+      hash += Fold(acc[lane] ^ keys[lane], acc[lane + 1] ^ keys[lane + 1]);
+   }
+   hash ^= hash >> 37;
+   hash *= 0x165667919E3779F9ULL;
+   hash ^= hash >> 32;
+   return hash;
+}
+
+Checksum::Checksum() : buffered_(0), stripe_(0), length_(0) {
+   acc_[0] = PRIME32_3;
+   acc_[1] = PRIME64_1;
+   acc_[2] = PRIME64_2;
+   acc_[3] = PRIME64_3;
+   acc_[4] = PRIME64_4;
+   acc_[5] = PRIME32_2;
+   acc_[6] = PRIME64_5;
+   acc_[7] = PRIME32_1;
+}
+
+void Checksum::Update(const int* data, size_t size) {
+   length_ += size;
+
+   // Complete the stripe held back by the last call first
+   if (buffered_ > 0) {
+      size_t take = DIGEST_STRIPE - buffered_ < size ? DIGEST_STRIPE - buffered_ : size;
+      memcpy(buffer_ + buffered_, data, take * sizeof(int));
+      buffered_ += take;
+      data += take;
+      size -= take;
+      if (buffered_ < DIGEST_STRIPE) {
+         return;
+      }
+      Stripes(buffer_, 1);
+      buffered_ = 0;
+   }
+
+   size_t whole = size / DIGEST_STRIPE;
+   Stripes(data, whole);
+   buffered_ = size - whole * DIGEST_STRIPE;
+   memcpy(buffer_, data + whole * DIGEST_STRIPE, buffered_ * sizeof(int));
+}
+
+void Checksum::Stripes(const int* data, size_t count) {
+   for (size_t stripe = 0; stripe < count; ++stripe) {
+      Accumulate(acc_, data + stripe * DIGEST_STRIPE, KEYS + stripe_);
+      if (++stripe_ == DIGEST_BLOCK_STRIPES) {
+         Scramble(acc_);
+         stripe_ = 0;
+      }
+   }
+}
+
+Digest Checksum::Value128() const {
+   uint64_t acc[DIGEST_LANES];
+   Digest digest;
+
+   // The partial stripe goes in zero padded, the length tells the padding from data
+   memcpy(acc, acc_, sizeof(acc));
+   if (buffered_ > 0) {
+      int last[DIGEST_STRIPE] = {};
+      memcpy(last, buffer_, buffered_ * sizeof(int));
+      Accumulate(acc, last, KEYS + stripe_);
+   }
+
+   digest.low = Merge(acc, KEYS, (uint64_t)length_ * PRIME64_1);
+   digest.high = Merge(acc, KEYS + DIGEST_LANES, ~((uint64_t)length_ * PRIME64_2));
+   return digest;
+}
+
+uint64_t SampleChecksum(const int* data, size_t size) {
+   return SampleDigest(data, size).low;
+}
+
+Digest SampleDigest(const int* data, size_t size) {
+   Checksum checksum;
+   checksum.Update(data, size);
+   return checksum.Value128();
+}
+
+std::string ChecksumToHex(uint64_t checksum) {
+   static const char HEX[] = "0123456789abcdef";
+   std::string text(16, '0');
+
+   for (int digit = 15; digit >= 0; --digit) {
+      text[digit] = HEX[checksum & 0xf];
+      checksum >>= 4;
+   }
+   return text;
+}
+
+bool ChecksumFromHex(const std::string& text, uint64_t& checksum) {
+   if (text.size() != 16) {
+      return false;
+   }
+   checksum = 0;
+   for (char c : text) {
+      int digit;
+      if (c >= '0' && c <= '9') {
+         digit = c - '0';
+      }
+      else if (c >= 'a' && c <= 'f') {
+         digit = c - 'a' + 10;
+      }
+      else {
+         return false;
+      }
+      checksum = (checksum << 4) | digit;
+   }
+   return true;
+}
+
+std::string DigestToHex(const Digest& digest) {
+   return ChecksumToHex(digest.high) + ChecksumToHex(digest.low);
+}
+
+bool DigestFromHex(const std::string& text, Digest& digest) {
+   return text.size() == 32 && ChecksumFromHex(text.substr(0, 16), digest.high) &&
+          ChecksumFromHex(text.substr(16), digest.low);
+}
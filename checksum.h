@@ -0,0 +1,74 @@
+// Checksum
+//
+// 128-bit digest of int32 samples, used to tell whether a sample is still the
+// one a saved result was computed from and whether two result files hold the
+// same sample. Not cryptographic.
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Ints per stripe, the 64 bytes taken by one accumulate step
+const int DIGEST_STRIPE = 16;
+
+// Stripes between two scrambles of the accumulators
+const int DIGEST_BLOCK_STRIPES = 16;
+
+const int DIGEST_LANES = 8;
+
+struct Digest {
+   uint64_t low = 0;
+   uint64_t high = 0;
+
+   bool operator==(const Digest& other) const { return low == other.low && high == other.high; }
+   bool operator!=(const Digest& other) const { return !(*this == other); }
+};
+
+/* Digest of a stream of ints fed in pieces, in the style of XXH3-128. Eight
+ 64-bit accumulators take a stripe at a time; each stripe of a block is mixed
+ with its own keys, so moving stripes around changes the digest, and the
+ accumulators are scrambled after every block. The accumulate step only needs
+ 32x32->64 bit multiplies, so it runs a stripe per two AVX2 (four SSE2)
+ multiplies. A partial stripe is held back until more ints arrive, so the
+ digest does not depend on how the input was split between Update() calls.
+ The value can be taken at any point and more ints added afterwards, which
+ gives the digest of a prefix and of the whole input in one pass. */
+class Checksum {
+public:
+   Checksum();
+
+   void Update(const int* data, size_t size);
+
+   // Digest of everything added so far
+   Digest Value128() const;
+
+   // Its low 64 bits, what the saved sort state keeps
+   uint64_t Value() const { return Value128().low; }
+
+   size_t Length() const { return length_; }
+
+private:
+   void Stripes(const int* data, size_t count);
+
+   uint64_t acc_[DIGEST_LANES];
+   int buffer_[DIGEST_STRIPE];   // The partial stripe held back
+   size_t buffered_;
+   int stripe_;                  // Stripes taken in the current block
+   size_t length_;
+};
+
+// Checksum of data[0..size-1], the low 64 bits of its digest
+uint64_t SampleChecksum(const int* data, size_t size);
+
+Digest SampleDigest(const int* data, size_t size);
+
+// Checksums as 16 hex digits and digests as 32, the forms they are saved in
+std::string ChecksumToHex(uint64_t checksum);
+bool ChecksumFromHex(const std::string& text, uint64_t& checksum);
+std::string DigestToHex(const Digest& digest);
+bool DigestFromHex(const std::string& text, Digest& digest);
+
+#endif
@@ -1,156 +1,370 @@
 #include <iostream>       // for input/output streams (cout, cerr)
 #include <fstream>        // for file input/output (ifstream)  
 #include <vector>         // for using vector data structure
-#include <set>           // for using set data structure
+#include <map>            // for using map data structure
+#include <set>            // for the samples whose digests differ
+#include <algorithm>      // for sorting the keys of a report entry
+#include <climits>        // for INT_MAX and LLONG_MAX
+#include <cerrno>         // for errno and ERANGE
+#include <cstdlib>        // for strtoll
 #include "json.hpp"       // include the JSON library
+#include "samplereader.h" // include the streaming sample reader
+#include "threadpool.h"   // include the thread pool for parallel comparisons
+#include "verify.h"       // include the vectorized comparison kernels
+#include "jsonwriter.h"   // include the streaming report writer
+#include "sampledigest.h" // include the digest sidecars
 
 using json = nlohmann::json;  // create shortcut for nlohmann::json
 using namespace std;          // use standard namespace
 
-// function to read and parse a JSON file
-// this function works almost identical to the main function from HW1
-// parameters are the filename, which should be a string
-json readJSONFile(const string& filename) { 
-    ifstream input_file(filename); // create input file stream object
-    
-    // check if file was successfully opened
-    if (!input_file.is_open()) {
-        throw runtime_error("Cannot open file: " + filename); // throw error if file cannot be opened
+// number of sample pairs handed to the thread pool at a time, per thread
+// bounds how many parsed samples are held in memory at once
+const int PAIRS_PER_THREAD = 4;
+
+// a sample found in both files, waiting to be compared
+struct SamplePair {
+    string name;           // sample name
+    Sample sample1;        // copy from the first file
+    Sample sample2;        // copy from the second file
+    bool conflict = false; // set by compareSamples if the arrays differ
+    bool size_conflict = false;   // set if the arrays have different sizes
+    size_t total_mismatches = 0;  // number of positions where the arrays differ
+    vector<size_t> positions;     // positions of the reported mismatches
+};
+
+// function to compare one sample that exists in both files
+// fills in the mismatches and sets pair.conflict if the arrays differ
+// only the first max_mismatches positions are reported (0 reports all of them)
+// parameters are the sample pair and the mismatch limit
+void compareSamples(SamplePair& pair, size_t max_mismatches) {
+    const int* array1 = pair.sample1.data;  // array from first file
+    const int* array2 = pair.sample2.data;  // array from second file
+    size_t size1 = pair.sample1.size;       // size of array from first file
+    size_t size2 = pair.sample2.size;       // size of array from second file
+    
+    // compare array sizes
+    if (size1 != size2) {
+        pair.conflict = true;  // mark the conflict
+        pair.size_conflict = true;  // reported without the arrays
+        return;  // nothing more to compare
     }
     
-    // create JSON object to store parsed data
-    json data;
-    try {
-        // parse the entire JSON file into the data object
-        input_file >> data;  // read and parse from filestream
-    } catch (exception& e) {
-        throw runtime_error("Invalid JSON in file: " + filename); // throw error for invalid JSON format
+    // identical samples are the common case, a single memcmp settles them
+    if (SamplesEqual(array1, array2, size1)) {
+        return;  // no mismatches
     }
     
-    input_file.close(); // clsoe file
-    return data;  // return parsed data
+    // find the positions where the arrays differ
+    pair.total_mismatches = FindMismatches(array1, array2, size1, max_mismatches, &pair.positions);
+    pair.conflict = true;  // mark the conflict, the arrays go in the output
+}
+    
+// function to write the output entry for a sample that exists in only one file
+// or whose arrays have different sizes, the reason goes under the given key
+void writeConflict(JsonWriter& output, const string& name, const string& key, const string& message) {
+    output.Key(name);
+    output.BeginObject();
+    output.Key("Mismatches");
+    output.BeginObject();
+    output.Key(key);
+    output.String(message);  // output message
+    output.EndObject();
+    output.EndObject();
+}
+            
+// function to compare a batch of sample pairs in parallel
+// results are written to output in batch order once every pair is done
+void compareBatch(vector<SamplePair>& batch, ThreadPool& pool, const string& filename1, const string& filename2,
+                  size_t max_mismatches, JsonWriter& output, int& samples_with_conflicts) {
+    {
+        TaskGroup group(pool);  // one task per sample pair
+        for (SamplePair& pair : batch) {
+            SamplePair* task_pair = &pair;  // pointer so the task does not copy the samples
+            group.Run([task_pair, max_mismatches] {
+                compareSamples(*task_pair, max_mismatches);
+            });
+        }
+        group.Wait();  // wait for every comparison to finish
+    }
+    
+    // write the results
+    for (SamplePair& pair : batch) {
+        if (!pair.conflict) {
+            continue;  // nothing to report
+        }
+        samples_with_conflicts++;  // increment conflict counter
+        if (pair.size_conflict) {
+            writeConflict(output, pair.name, "size", "Arrays have different sizes");
+            continue;
+        }
+        
+        const int* array1 = pair.sample1.data;  // array from first file
+        const int* array2 = pair.sample2.data;  // array from second file
+        output.Key(pair.name);
+        output.BeginObject();
+        
+        // the keys of the entry go in the order the json DOM sorted them in
+        vector<string> keys = {filename1, filename2, "Mismatches"};
+        if (max_mismatches > 0) {
+            keys.push_back("TotalMismatches");
+        }
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());  // the same file twice is one key
+        for (const string& key : keys) {
+            output.Key(key);
+            if (key == "Mismatches") {
+                // key is position, value is [file1_value, file2_value]
+                SortAsKeys(pair.positions);  // "10" before "9", as the DOM had them
+                output.BeginObject();
+                for (size_t i : pair.positions) {
+                    output.Key(i);
+                    output.BeginArray();
+                    output.Int(array1[i]);
+                    output.Int(array2[i]);
+                    output.EndArray();
+                }
+                output.EndObject();
+            }
+            else if (key == "TotalMismatches") {
+                output.UInt(pair.total_mismatches);  // the report may be cut short, so give the full count
+            }
+            else if (key == filename2) {
+                output.IntArray(array2, pair.sample2.size);  // add array from second file
+            }
+            else {
+                output.IntArray(array1, pair.sample1.size);  // add array from first file
+            }
+        }
+        output.EndObject();
+    }
+    batch.clear();  // release the samples
+}
+
+// parse a flag value as a whole number in [low, high]
+// returns false if it is not one, so a bad value is reported instead of aborting the program
+bool ParseNumber(const string& value, long long low, long long high, long long& number) {
+    char* end = nullptr;  // first character after the number
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > high) {
+        return false;
+    }
+    number = parsed;
+    return true;
 }
 
 int main(int argc, char** argv) {
     // check if correct number of command line arguments provided
-    // argc should be 3: program name + first filename + second filename
-    if (argc != 3) {
-        cerr << "Usage: " << argv[0] << " <file1.json> <file2.json>" << endl; // print error message to standard error
+    // argc should be at least 3: program name + first filename + second filename
+    // followed by the optional --threads N, --max-mismatches K, --compact and --no-digests flags
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <file1.json> <file2.json> [--threads N] [--max-mismatches K] [--compact]"
+             << " [--no-digests]" << endl; // print error message to standard error
+        cerr << "       samples whose .digest sidecars match in both files are not compared again" << endl;
+        cerr << "       samples are reported in the order they are compared, metadata last" << endl;
+        cerr << "       the report is streamed, after an error what was already written is partial" << endl;
         return 1;  // return error code 1 indicating failure
     }
     
+    int num_threads = 0;        // threads used to compare samples, 0 is one per hardware thread
+    size_t max_mismatches = 0;  // mismatches reported per sample, 0 reports all of them
+    bool compact = false;       // write the report without indentation
+    bool no_digests = false;    // compare every sample even if both files have digest sidecars
+    for (int arg = 3; arg < argc; arg++) {
+        string flag = argv[arg];  // name of the flag
+        long long number = 0;     // value of a numeric flag
+        if ((flag == "--threads" || flag == "--max-mismatches") && arg + 1 < argc &&
+            !ParseNumber(argv[arg + 1], 0, flag == "--threads" ? INT_MAX : LLONG_MAX, number)) {
+            cerr << "Error: Invalid value for " << flag << ": " << argv[arg + 1] << endl; // not a number or negative
+            return 1;  // return error code 1 indicating failure
+        }
+        if (flag == "--threads" && arg + 1 < argc) {
+            num_threads = number;
+            ++arg;  // skip the value
+        }
+        else if (flag == "--max-mismatches" && arg + 1 < argc) {
+            max_mismatches = number;
+            ++arg;  // skip the value
+        }
+        else if (flag == "--compact") {
+            compact = true;
+        }
+        else if (flag == "--no-digests") {
+            no_digests = true;
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+    
     // store filenames from command line arguments
 
     // define the variables of the filenames
     string filename1 = argv[1];  // argv[1] is the first input JSON filename
     string filename2 = argv[2];  // argv[2] is the second input JSON filename
     
-    // read both JSON files using previously defined function
-    // creating two objects to store data 
-    json data1, data2;
+    // open both files, samples are read one at a time below
+    // creating two readers, one per file
+    SampleReader reader1, reader2;
+    DigestIndex digests1, digests2;  // digest sidecars, used only if both files have a current one
+    bool use_digests = false;        // compare digests first
     try {
-        data1 = readJSONFile(filename1);  // read first JSON file
-        data2 = readJSONFile(filename2);  // read second JSON file
+        reader1.Open(filename1);  // open first JSON file
+        reader2.Open(filename2);  // open second JSON file
+        if (!no_digests) {
+            use_digests = digests1.Open(filename1) && digests2.Open(filename2);
+        }
     } catch (const exception& e) {
         cerr << "Error: " << e.what() << endl; // print error message if file reading fails
         return 1;  // return error code 1 indicating failure
     }
     
-    // create output JSON object 
-    // this contains comparison results
-    json output;
+    // the comparison results are written to standard output as each batch finishes
+    // nothing but the current batch and the unpaired samples is held in memory
+    JsonWriter output(cout, !compact);  // 4-space indentation unless --compact
     int samples_with_conflicts = 0;  // counter for samples with conflictions
 
-    // get metadata from both files for output
-    int arraySize1 = data1["metadata"]["arraySize"];    // array size from first file
-    int numSamples1 = data1["metadata"]["numSamples"];  // number of samples from first file
-    int arraySize2 = data2["metadata"]["arraySize"];    // array size from second file  
-    int numSamples2 = data2["metadata"]["numSamples"];  // number of samples from second file
+    // samples read from one file whose partner has not been read from the other file yet
+    // files written in the same sample order keep these nearly empty
+    map<string, Sample> pending1, pending2;
 
-    
-    set<string> all_sample_names; // string vector object to hold all unique sample names
-    // this makes sure we check all samples that exist in either file
-    
-    // iterate through first file and collect sample names
-    // parameters are start and end of data
-    for (auto it = data1.begin(); it != data1.end(); ++it) {
-        string sample_name = it.key();  // get the sample name from current element
-        if (sample_name != "metadata") {  // skip metadata section
-            all_sample_names.insert(sample_name);  // add sample name to the set
+    // with digests, only the samples whose digests differ or that one file lacks are compared
+    // the others are read past without being touched, for a binary file that is just an index lookup
+    set<string> suspects;            // samples that still have to be compared
+    size_t samples_matched = 0;      // samples with the same length and digest in both files
+    if (use_digests) {
+        for (const auto& entry : digests1.Entries()) {
+            const DigestEntry* other = digests2.Find(entry.first);  // the same sample in the second file
+            if (other != nullptr && other->length == entry.second.length && other->digest == entry.second.digest) {
+                samples_matched++;
+            }
+            else {
+                suspects.insert(entry.first);
+            }
+        }
+        for (const auto& entry : digests2.Entries()) {
+            if (digests1.Find(entry.first) == nullptr) {
+                suspects.insert(entry.first);  // missing from the first file
+            }
         }
     }
+
+    ThreadPool pool(num_threads);  // threads that compare the sample pairs
+    vector<SamplePair> batch;      // sample pairs waiting to be compared
+    size_t batch_size = pool.NumThreads() * PAIRS_PER_THREAD;  // pairs compared together
     
-    // iterate through second file and collect sample names
-    // parameters are start and end of data
-    for (auto it = data2.begin(); it != data2.end(); ++it) {
-        string sample_name = it.key();  // get the sample name from current element
-        if (sample_name != "metadata") {  // skip metadata section
-            all_sample_names.insert(sample_name);  // add sample name to the set
+    string sample_name;  // name of the sample that was just read
+    Sample sample;       // the sample that was just read
+    bool more1 = true;   // tracker if the first file has samples left
+    bool more2 = true;   // tracker if the second file has samples left
+    
+    // read both files side by side, pairing each sample as soon as both copies are in
+    try {
+        output.BeginObject();
+        while (more1 || more2) {
+            // next sample from the first file
+            if (more1 && (more1 = reader1.NextName(sample_name)) && use_digests && !suspects.count(sample_name)) {
+                reader1.Skip();  // the digests match, nothing to compare or parse
+            }
+            else if (more1) {
+                reader1.ReadValues(sample);  // values of the sample that was just named
+                auto match = pending2.find(sample_name);  // check if the second file already had it
+                if (match != pending2.end()) {
+                    batch.emplace_back();  // pair the sample up
+                    batch.back().name = sample_name;
+                    batch.back().sample1 = std::move(sample);
+                    batch.back().sample2 = std::move(match->second);
+                    pending2.erase(match);  // done with this sample
+                }
+                else {
+                    pending1[sample_name] = std::move(sample);  // wait for the second file
+                }
+                sample = Sample();  // start the next sample from scratch
+            }
+    
+            // next sample from the second file
+            if (more2 && (more2 = reader2.NextName(sample_name)) && use_digests && !suspects.count(sample_name)) {
+                reader2.Skip();  // the digests match, nothing to compare or parse
+            }
+            else if (more2) {
+                reader2.ReadValues(sample);  // values of the sample that was just named
+                auto match = pending1.find(sample_name);  // check if the first file already had it
+                if (match != pending1.end()) {
+                    batch.emplace_back();  // pair the sample up
+                    batch.back().name = sample_name;
+                    batch.back().sample1 = std::move(match->second);
+                    batch.back().sample2 = std::move(sample);
+                    pending1.erase(match);  // done with this sample
+                }
+                else {
+                    pending2[sample_name] = std::move(sample);  // wait for the first file
+                }
+                sample = Sample();  // start the next sample from scratch
+            }
+            
+            // compare a full batch across the thread pool
+            if (batch.size() >= batch_size) {
+                compareBatch(batch, pool, filename1, filename2, max_mismatches, output, samples_with_conflicts);
+            }
         }
-    }
     
-    // compare each sample that exists in either file
-    // parameters is the vector all_sample_names
-    for (const string& sample_name : all_sample_names) {
-        
-        // check if sample exists in both files using find() method
-        bool in_file1 = (data1.find(sample_name) != data1.end()) && sample_name != "metadata"; // file 1 check
-        bool in_file2 = (data2.find(sample_name) != data2.end()) && sample_name != "metadata"; // file 2 check
-        
-        // if sample missing from one file, that's a conflict
-        if (!in_file1 || !in_file2) {
+        // compare whatever is left in the last batch
+        compareBatch(batch, pool, filename1, filename2, max_mismatches, output, samples_with_conflicts);
+    
+        // anything still pending exists in only one file, that's a conflict
+        for (const auto& entry : pending1) {
             samples_with_conflicts++;  // Increment conflict counter
-            output[sample_name]["Mismatches"]["missing"] = "Sample missing from one file"; // output message
-            continue;  // skip to next sample
-        }
-        
-        // get the arrays from both files for this sample
-        vector<int> array1 = data1[sample_name];  // array from first file
-        vector<int> array2 = data2[sample_name];  // array from second file
-        
-        // compare array sizes
-        if (array1.size() != array2.size()) {
-            samples_with_conflicts++;  // increment conflict counter
-            output[sample_name]["Mismatches"]["size"] = "Arrays have different sizes"; // output message
-            continue;  // skip to next sample
+            writeConflict(output, entry.first, "missing", "Sample missing from one file");
         }
-        
-        // compare each element in the arrays
-        json mismatches;  // JSON object to store position mismatches
-        bool has_mismatches = false;  // tracker if we found any mismatches
-        
-        // parameters is array1 which stores data1
-        for (int i = 0; i < array1.size(); i++) {
-            // check if elements at position i are different
-            if (array1[i] != array2[i]) {
-                has_mismatches = true;  // set tracker to true
-                
-                // store the mismatch 
-                // key is position, value is [file1_value, file2_value]
-                mismatches[to_string(i)] = {array1[i], array2[i]};
-            }
+        for (const auto& entry : pending2) {
+            samples_with_conflicts++;  // Increment conflict counter
+            writeConflict(output, entry.first, "missing", "Sample missing from one file");
         }
-        
-        // add to output if there are mismatches
-        if (has_mismatches) {
-            samples_with_conflicts++;  // increment conflict counter
-            output[sample_name][filename1] = array1;  // add array from first file
-            output[sample_name][filename2] = array2;  // add array from second file
-            output[sample_name]["Mismatches"] = mismatches;  // add the mismatches
+    
+        // get metadata from both files for output
+        // the metadata sections are complete once every sample has been read
+        int arraySize1 = reader1.Metadata().at("arraySize");    // array size from first file
+        int numSamples1 = reader1.Metadata().at("numSamples");  // number of samples from first file
+        int arraySize2 = reader2.Metadata().at("arraySize");    // array size from second file  
+        int numSamples2 = reader2.Metadata().at("numSamples");  // number of samples from second file
+    
+        // add metadata section to the output, after every sample
+        output.Key("metadata");
+        output.BeginObject();
+        output.Key("File1");
+        output.BeginObject();
+        output.Key("arraySize");
+        output.Int(arraySize1);  // array size from first file
+        output.Key("name");
+        output.String(filename1);  // first filename
+        output.Key("numSamples");
+        output.Int(numSamples1);  // sample count from first file
+        output.EndObject();
+        output.Key("File2");
+        output.BeginObject();
+        output.Key("arraySize");
+        output.Int(arraySize2);  // array size from second file
+        output.Key("name");
+        output.String(filename2);  // second filename
+        output.Key("numSamples");
+        output.Int(numSamples2);  // sample count from second file
+        output.EndObject();
+        if (use_digests) {
+            output.Key("samplesMatchedByDigest");
+            output.UInt(samples_matched);  // samples settled by their digests alone
         }
-    }
+        output.Key("samplesWithConflictingResults");
+        output.Int(samples_with_conflicts);  // conflict count
+        output.EndObject();
     
-    // add metadata section to output JSON
-    output["metadata"]["File1"]["name"] = filename1;  // first filename
-    output["metadata"]["File1"]["arraySize"] = arraySize1;  // array size from first file
-    output["metadata"]["File1"]["numSamples"] = numSamples1;  // sample count from first file
-    output["metadata"]["File2"]["name"] = filename2;  // second filename
-    output["metadata"]["File2"]["arraySize"] = arraySize2;  // array size from second file
-    output["metadata"]["File2"]["numSamples"] = numSamples2;  // sample count from second file
-    output["metadata"]["samplesWithConflictingResults"] = samples_with_conflicts;  // conflict count
-    
-    // print the final output JSON to standard output
-    cout << output.dump(4) << endl;  // dump(4) for 4-space indent 
+        // close the report, this flushes it to standard output
+        output.EndObject();
+    } catch (const exception& e) {
+        output.Abandon();  // no unterminated report after what was already streamed
+        cerr << "Error: " << e.what() << endl; // print error message if a file is malformed or the report cannot be written
+        return 1;  // return error code 1 indicating failure
+    }
     
     return 0;  // Return 0 program works! :)
     
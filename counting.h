@@ -0,0 +1,107 @@
+// Counting
+//
+// Instrumentation policies for the sorts. Every sort is a template on one of
+// these, so the uninstrumented build and the counted build share one source.
+// Besides compares and memory accesses, sorts that stream the whole array
+// through memory count each pass over it with Pass(): a merge pass, a radix
+// scatter, a copy back. That is what a cache-blocked sort saves.
+
+#ifndef COUNTING_H
+#define COUNTING_H
+
+/* Part of a sort that a count is charged to. Each counting kernel sets its
+ phase before it counts anything. */
+enum SortPhase {
+   PHASE_OTHER,
+   PHASE_PIVOT,
+   PHASE_PARTITION,
+   PHASE_INSERTION,
+   PHASE_HEAP,
+   PHASE_MERGE,
+   PHASE_COPY,
+   PHASE_DISTRIBUTE,
+   PHASE_RUNS,
+   NUM_SORT_PHASES
+};
+
+const char* const SORT_PHASE_NAMES[NUM_SORT_PHASES] = {
+   "Other", "Pivot", "Partition", "Insertion", "Heap", "Merge", "Copy", "Distribute", "Runs"
+};
+
+/* Counts nothing. Every call is empty and inlines away, leaving the plain sort. */
+struct NoCount {
+   void Compare(long long = 1) {}
+   void Access(long long = 1) {}
+   void Pass(long long = 1) {}
+   void SetPhase(SortPhase) {}
+   void Add(const NoCount&) {}
+};
+
+/* 64-bit compare and memory-access totals */
+struct Count64 {
+   long long comp_count = 0;
+   long long mem_count = 0;
+   long long pass_count = 0;
+
+   void Compare(long long count = 1) { comp_count += count; }
+   void Access(long long count = 1) { mem_count += count; }
+   void Pass(long long count = 1) { pass_count += count; }
+   void SetPhase(SortPhase) {}
+   void Add(const Count64& other) {
+      comp_count += other.comp_count;
+      mem_count += other.mem_count;
+      pass_count += other.pass_count;
+   }
+};
+
+/* Compare and memory-access totals broken down by SortPhase. Passes are
+ only totalled, a pass belongs to whichever phase streams the array. */
+struct PhaseHistogram {
+   long long comp_count[NUM_SORT_PHASES] = {};
+   long long mem_count[NUM_SORT_PHASES] = {};
+   long long pass_count = 0;
+   SortPhase phase = PHASE_OTHER;
+
+   void Compare(long long count = 1) { comp_count[phase] += count; }
+   void Access(long long count = 1) { mem_count[phase] += count; }
+   void Pass(long long count = 1) { pass_count += count; }
+   void SetPhase(SortPhase newPhase) { phase = newPhase; }
+   void Add(const PhaseHistogram& other) {
+      for (int i = 0; i < NUM_SORT_PHASES; ++i) {
+         comp_count[i] += other.comp_count[i];
+         mem_count[i] += other.mem_count[i];
+      }
+      pass_count += other.pass_count;
+   }
+
+   long long TotalCompares() const {
+      long long total = 0;
+      for (int i = 0; i < NUM_SORT_PHASES; ++i) {
+         total += comp_count[i];
+      }
+      return total;
+   }
+   long long TotalAccesses() const {
+      long long total = 0;
+      for (int i = 0; i < NUM_SORT_PHASES; ++i) {
+         total += mem_count[i];
+      }
+      return total;
+   }
+};
+
+/* Adds into a caller's (int& comp_count, int& mem_count) pair, used by the
+ original non-template entry points. Passes are not kept. */
+struct IntCounts {
+   int& comp_count;
+   int& mem_count;
+
+   IntCounts(int& comp, int& mem) : comp_count(comp), mem_count(mem) {}
+
+   void Compare(long long count = 1) { comp_count += count; }
+   void Access(long long count = 1) { mem_count += count; }
+   void Pass(long long = 1) {}
+   void SetPhase(SortPhase) {}
+};
+
+#endif
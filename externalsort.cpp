@@ -0,0 +1,288 @@
+// External Sort
+//
+// Sorts int32 streams larger than memory. The input is read in chunks that fit
+// the memory budget, each chunk is sorted in memory with Sort() and spilled to
+// a temporary run file, and the runs are merged k-way through a loser tree
+// with large sequential reads and writes.
+
+#include "externalsort.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "losertree.h"
+
+#include <unistd.h>
+
+IntFileReader::IntFileReader() : pos_(0), end_(0) {
+}
+
+void IntFileReader::Open(const std::string& filename, size_t bufferSize) {
+   Close();
+   filename_ = filename;
+   input_.open(filename, std::ios::binary);
+   if (!input_.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+   buffer_.resize(std::max(bufferSize / sizeof(int), (size_t)1));
+}
+
+void IntFileReader::Close() {
+   if (input_.is_open()) {
+      input_.close();
+   }
+   input_.clear();
+   pos_ = 0;
+   end_ = 0;
+}
+
+size_t IntFileReader::ReadFile(int* data, size_t count) {
+   input_.read((char*)data, count * sizeof(int));
+   size_t bytes = input_.gcount();
+
+   if (bytes % sizeof(int) != 0) {
+      throw std::runtime_error("Invalid sample file: " + filename_);
+   }
+   if (input_.bad()) {
+      throw std::runtime_error("Cannot open file: " + filename_);
+   }
+   return bytes / sizeof(int);
+}
+
+bool IntFileReader::Refill() {
+   pos_ = 0;
+   end_ = ReadFile(buffer_.data(), buffer_.size());
+   return end_ > 0;
+}
+
+size_t IntFileReader::Read(int* data, size_t count) {
+   size_t buffered = std::min(count, end_ - pos_);
+
+   // Hand out what is buffered, then read the rest straight into data
+   std::copy(buffer_.data() + pos_, buffer_.data() + pos_ + buffered, data);
+   pos_ += buffered;
+   if (buffered == count) {
+      return count;
+   }
+   return buffered + ReadFile(data + buffered, count - buffered);
+}
+
+IntFileWriter::IntFileWriter() : count_(0) {
+}
+
+IntFileWriter::~IntFileWriter() {
+   if (output_.is_open()) {
+      try {
+         Close();
+      } catch (const std::exception&) {
+         // Nothing to report to from a destructor
+      }
+   }
+}
+
+void IntFileWriter::Open(const std::string& filename, size_t bufferSize) {
+   filename_ = filename;
+   output_.open(filename, std::ios::binary | std::ios::trunc);
+   if (!output_.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+   buffer_.resize(std::max(bufferSize / sizeof(int), (size_t)1));
+   count_ = 0;
+}
+
+void IntFileWriter::Flush() {
+   output_.write((const char*)buffer_.data(), count_ * sizeof(int));
+   count_ = 0;
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
+
+void IntFileWriter::Write(const int* data, size_t count) {
+   // Large blocks skip the buffer
+   if (count >= buffer_.size()) {
+      Flush();
+      output_.write((const char*)data, count * sizeof(int));
+      if (!output_) {
+         throw std::runtime_error("Cannot write file: " + filename_);
+      }
+      return;
+   }
+   for (size_t pos = 0; pos < count; ++pos) {
+      Put(data[pos]);
+   }
+}
+
+void IntFileWriter::Close() {
+   Flush();
+   output_.close();
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
+
+long long MergeRunFiles(const std::vector<std::string>& inputs, const std::string& output, size_t bufferSize) {
+   int k = inputs.size();
+   std::vector<IntFileReader> readers(k);
+   LoserTree<int> tree(k);
+   IntFileWriter writer;
+   long long written = 0;
+   int value = 0;
+
+   for (int source = 0; source < k; ++source) {
+      readers[source].Open(inputs[source], bufferSize);
+      if (readers[source].Next(value)) {
+         tree.Set(source, value);
+      }
+   }
+   tree.Build();
+
+   writer.Open(output, bufferSize);
+   while (!tree.Empty()) {
+      writer.Put(tree.WinnerValue());
+      ++written;
+      if (readers[tree.Winner()].Next(value)) {
+         tree.Replace(value);
+      }
+      else {
+         tree.ReplaceExhausted();
+      }
+   }
+   writer.Close();
+   return written;
+}
+
+/* Run files of one sort, removed when it finishes or fails */
+class RunFiles {
+public:
+   explicit RunFiles(const std::string& dir) : dir_(dir) {
+      if (dir_.empty()) {
+         const char* tmp = getenv("TMPDIR");
+         dir_ = tmp != nullptr && *tmp != '\0' ? tmp : "/tmp";
+      }
+   }
+
+   ~RunFiles() {
+      for (const std::string& name : names_) {
+         std::remove(name.c_str());
+      }
+   }
+
+   // Create a new empty run file and return its name
+   std::string Create() {
+      std::string name = dir_ + "/externalsort-XXXXXX";
+      int fd = mkstemp(&name[0]);
+
+      if (fd < 0) {
+         throw std::runtime_error("Cannot write file: " + dir_ + "/externalsort-XXXXXX");
+      }
+      close(fd);
+      names_.push_back(name);
+      return name;
+   }
+
+   void Remove(const std::string& name) {
+      std::remove(name.c_str());
+      names_.erase(std::find(names_.begin(), names_.end(), name));
+   }
+
+private:
+   std::string dir_;
+   std::vector<std::string> names_;
+};
+
+/* Fill chunk from source, returns false if source had nothing left */
+static bool ReadChunk(const IntSource& source, std::vector<int>& chunk, size_t chunkSize) {
+   size_t count = 0;
+   size_t got = 0;
+
+   chunk.resize(chunkSize);
+   while (count < chunkSize && (got = source(chunk.data() + count, chunkSize - count)) > 0) {
+      count += got;
+   }
+   chunk.resize(count);
+   return count > 0;
+}
+
+ExternalSortStats ExternalSort(const IntSource& source, const std::string& output,
+                               const ExternalSortOptions& options) {
+   ExternalSortStats stats;
+   RunFiles files(options.tempDir);
+   std::vector<std::string> runs;
+   std::vector<int> chunk;
+   size_t chunkSize = std::max(options.memoryBudget / EXTERNAL_SORT_CHUNK_SHARE / sizeof(int), (size_t)1);
+   size_t buffers = std::max(options.memoryBudget / EXTERNAL_SORT_MIN_BUFFER, (size_t)3);
+   int fanIn = buffers - 1;  // One buffer goes to the output
+   bool more = ReadChunk(source, chunk, chunkSize);
+
+   // Run generation: sort each chunk in memory and spill it
+   while (more) {
+      IntFileWriter writer;
+
+      Sort(&chunk, options.thresholds);
+      stats.elements += chunk.size();
+
+      // Look ahead so a single chunk goes straight to the output
+      std::vector<int> sorted;
+      sorted.swap(chunk);
+      more = ReadChunk(source, chunk, chunkSize);
+      if (!more && runs.empty()) {
+         writer.Open(output);
+         writer.Write(sorted.data(), sorted.size());
+         writer.Close();
+         stats.runs = 1;
+         return stats;
+      }
+
+      runs.push_back(files.Create());
+      writer.Open(runs.back());
+      writer.Write(sorted.data(), sorted.size());
+      writer.Close();
+   }
+   std::vector<int>().swap(chunk);  // Give the chunk memory to the merge buffers
+
+   stats.runs = runs.size();
+   if (runs.empty()) {
+      IntFileWriter writer;
+      writer.Open(output);
+      writer.Close();
+      return stats;
+   }
+
+   // Merge fanIn runs at a time until one pass can finish the job
+   while ((int)runs.size() > fanIn) {
+      std::vector<std::string> merged;
+
+      for (size_t first = 0; first < runs.size(); first += fanIn) {
+         std::vector<std::string> group(runs.begin() + first,
+                                        runs.begin() + std::min(first + fanIn, runs.size()));
+         if (group.size() == 1) {
+            merged.push_back(group[0]);
+            continue;
+         }
+         merged.push_back(files.Create());
+         MergeRunFiles(group, merged.back(), options.memoryBudget / (group.size() + 1));
+         for (const std::string& name : group) {
+            files.Remove(name);
+         }
+      }
+      runs.swap(merged);
+      stats.fanIn = fanIn;
+      ++stats.mergePasses;
+   }
+
+   MergeRunFiles(runs, output, options.memoryBudget / (runs.size() + 1));
+   stats.fanIn = std::max(stats.fanIn, (int)runs.size());
+   ++stats.mergePasses;
+   return stats;
+}
+
+ExternalSortStats ExternalSort(const std::string& input, const std::string& output,
+                               const ExternalSortOptions& options) {
+   IntFileReader reader;
+
+   reader.Open(input);
+   return ExternalSort([&reader](int* data, size_t count) { return reader.Read(data, count); },
+                       output, options);
+}
@@ -0,0 +1,97 @@
+#include <iostream>       // for input/output streams (cout, cerr)
+#include <string>         // for using string
+#include <algorithm>      // for min and copy
+#include "json.hpp"       // include the JSON library for the summary
+#include "samplefile.h"   // include the binary sample file reader
+#include "externalsort.h" // include the external-memory sort
+
+using json = nlohmann::json;  // create shortcut for nlohmann::json
+using namespace std;          // use standard namespace
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be at least 3
+    // program name + input filename + output filename, followed by the optional flags
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <input> <output.raw> [--memory MB] [--temp DIR] [--sample NAME]"
+             << " [--thresholds FILE]" << endl; // print error message to standard error
+        cerr << "       <input> is a raw file of native int32 values or a binary sample file" << endl;
+        return 1;  // return error code 1 indicating failure
+    }
+
+    string input_filename = argv[1];   // argv[1] is the input filename
+    string output_filename = argv[2];  // argv[2] is the sorted raw int32 output
+    ExternalSortOptions options;       // memory budget, run directory and thresholds
+    string sample_name;                // sample to sort from a binary sample file, empty sorts the first one
+
+    try {
+        for (int arg = 3; arg < argc; arg++) {
+            string flag = argv[arg];  // name of the flag
+            if (arg + 1 >= argc) {
+                cerr << "Error: Missing value for " << flag << endl; // every flag takes a value
+                return 1;  // return error code 1 indicating failure
+            }
+            string value = argv[++arg];  // value of the flag
+            if (flag == "--memory") {
+                options.memoryBudget = stoull(value) << 20;  // megabytes to bytes
+            }
+            else if (flag == "--temp") {
+                options.tempDir = value;
+            }
+            else if (flag == "--sample") {
+                sample_name = value;
+            }
+            else if (flag == "--thresholds") {
+                options.thresholds = LoadSortThresholds(value);
+            }
+            else {
+                cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+
+        ExternalSortStats stats;  // what the sort did
+        if (IsBinarySampleFile(input_filename)) {
+            // the payload is read through the mapping, only the pages being copied are resident
+            MappedSampleFile samples;
+            samples.Open(input_filename);
+            size_t index = 0;  // index of the sample to sort
+            while (!sample_name.empty() && index < samples.SampleCount() && samples.Name(index) != sample_name) {
+                index++;
+            }
+            if (index >= samples.SampleCount()) {
+                cerr << "Error: No sample " << sample_name << " in " << input_filename << endl; // nothing to sort
+                return 1;  // return error code 1 indicating failure
+            }
+
+            const int* data = samples.Data(index);  // payload of the sample
+            size_t remaining = samples.Size(index);  // values not handed to the sort yet
+            stats = ExternalSort([&](int* chunk, size_t count) {
+                count = min(count, remaining);
+                copy(data, data + count, chunk);
+                data += count;
+                remaining -= count;
+                return count;
+            }, output_filename, options);
+        }
+        else {
+            stats = ExternalSort(input_filename, output_filename, options);
+        }
+
+        // print a summary of the sort
+        json output;
+        output["file"] = input_filename;                  // name of the input
+        output["output"] = output_filename;               // name of the sorted output
+        output["elements"] = stats.elements;              // number of values sorted
+        output["memoryBudget"] = options.memoryBudget;    // bytes the sort was allowed
+        output["runs"] = stats.runs;                      // sorted runs spilled to disk
+        output["fanIn"] = stats.fanIn;                    // most runs merged at once
+        output["mergePasses"] = stats.mergePasses;        // passes over the data after run generation
+        cout << output.dump(4) << endl;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if reading, sorting or writing fails
+        return 1;  // return error code 1 indicating failure
+    }
+
+    return 0;  // Return 0 :)
+}
@@ -0,0 +1,121 @@
+// External Sort
+//
+// Sorts int32 streams larger than memory. The input is read in chunks that fit
+// the memory budget, each chunk is sorted in memory with Sort() and spilled to
+// a temporary run file, and the runs are merged k-way through a loser tree
+// with large sequential reads and writes.
+
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "selector.h"
+
+// Smallest buffer, in bytes, given to each run file during a merge
+const size_t EXTERNAL_SORT_MIN_BUFFER = 1 << 20;
+
+/* A chunk gets 1/EXTERNAL_SORT_CHUNK_SHARE of the memory budget, the rest is
+ left for the scratch space of the in-memory sort (radix sort copies the
+ chunk, counting sort keeps up to countingMaxRange counts per element) */
+const size_t EXTERNAL_SORT_CHUNK_SHARE = 4;
+
+struct ExternalSortOptions {
+   size_t memoryBudget = (size_t)256 << 20;  // Bytes for run generation and for the merge buffers
+   std::string tempDir;                       // Directory for run files, empty uses TMPDIR or /tmp
+   SortThresholds thresholds;                 // Crossovers for sorting each chunk
+};
+
+struct ExternalSortStats {
+   long long elements = 0;
+   int runs = 0;           // Sorted runs written by run generation
+   int fanIn = 0;          // Most runs merged at once
+   int mergePasses = 0;    // Merge passes over the whole data, 0 if it fit in one chunk
+};
+
+/* Copies up to count values into data and returns how many it copied, 0 once
+ the stream is exhausted */
+typedef std::function<size_t(int* data, size_t count)> IntSource;
+
+/* Buffered reader for a file of native int32 values. Errors throw
+ runtime_error. */
+class IntFileReader {
+public:
+   IntFileReader();
+
+   void Open(const std::string& filename, size_t bufferSize = EXTERNAL_SORT_MIN_BUFFER);
+   void Close();
+
+   // Copy up to count values into data, returns how many were read (0 at end of file)
+   size_t Read(int* data, size_t count);
+
+   // Next value, false at end of file
+   bool Next(int& value) {
+      if (pos_ == end_ && !Refill()) {
+         return false;
+      }
+      value = buffer_[pos_++];
+      return true;
+   }
+
+private:
+   bool Refill();
+   size_t ReadFile(int* data, size_t count);
+
+   std::string filename_;
+   std::ifstream input_;
+   std::vector<int> buffer_;
+   size_t pos_;
+   size_t end_;
+};
+
+/* Buffered writer for a file of native int32 values. Errors throw
+ runtime_error. */
+class IntFileWriter {
+public:
+   IntFileWriter();
+   ~IntFileWriter();
+
+   void Open(const std::string& filename, size_t bufferSize = EXTERNAL_SORT_MIN_BUFFER);
+
+   // Flush the buffer and close the file
+   void Close();
+
+   void Put(int value) {
+      if (count_ == buffer_.size()) {
+         Flush();
+      }
+      buffer_[count_++] = value;
+   }
+
+   void Write(const int* data, size_t count);
+
+private:
+   void Flush();
+
+   std::string filename_;
+   std::ofstream output_;
+   std::vector<int> buffer_;
+   size_t count_;
+};
+
+/* Merge the sorted int32 files in inputs into output through a loser tree,
+ giving every file a read buffer of bufferSize bytes. Returns the number of
+ values written. */
+long long MergeRunFiles(const std::vector<std::string>& inputs, const std::string& output, size_t bufferSize);
+
+/* Sort every value from source into the int32 file output without holding
+ more than about options.memoryBudget bytes. When the runs outnumber the merge
+ buffers that fit the budget they are merged in several passes. Run files are
+ removed when the sort finishes or fails. */
+ExternalSortStats ExternalSort(const IntSource& source, const std::string& output,
+                               const ExternalSortOptions& options = ExternalSortOptions());
+
+// ExternalSort() of a file of native int32 values
+ExternalSortStats ExternalSort(const std::string& input, const std::string& output,
+                               const ExternalSortOptions& options = ExternalSortOptions());
+
+#endif
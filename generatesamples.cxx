@@ -0,0 +1,137 @@
+#include <iostream>       // for input/output streams (cout, cerr)
+#include <string>         // for using string
+#include <vector>         // for using vector data structure
+#include <climits>        // for INT_MIN, INT_MAX and LLONG_MAX
+#include <cerrno>         // for errno and ERANGE
+#include <cstdlib>        // for strtoll
+#include "samplefile.h"   // include the binary sample file writer
+#include "workload.h"     // include the seeded sample generator
+
+using namespace std;          // use standard namespace
+
+// parse a flag value as a whole number in [low, high]
+// returns false if it is not one, so a bad value is reported instead of aborting the program
+bool ParseNumber(const string& value, long long low, long long high, long long& number) {
+    char* end = nullptr;  // first character after the number
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > high) {
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be at least 2
+    // program name + output filename, followed by the optional flags
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <output> [--dist NAME] [--size N] [--samples N] [--seed N]"
+             << " [--swaps N] [--unique N] [--runs N] [--format json|binary]" << endl; // print error message to standard error
+        cerr << "       NAME is one of";
+        for (int dist = 0; dist < NUM_DISTRIBUTIONS; dist++) {
+            cerr << " " << DISTRIBUTION_NAMES[dist];
+        }
+        cerr << endl;
+        return 1;  // return error code 1 indicating failure
+    }
+    
+    string output_filename = argv[1];          // argv[1] is the file to write
+    Distribution distribution = DIST_UNIFORM;  // distribution of every sample
+    int array_size = 1000;                     // values per sample
+    int num_samples = 10;                      // number of samples
+    uint64_t seed = 1;                         // the same seed writes the same file
+    bool binary = false;                       // write a binary sample file instead of JSON
+    WorkloadOptions options;                   // parameters of the distributions
+    for (int arg = 2; arg < argc; arg += 2) {
+        string flag = argv[arg];  // name of the flag
+        if (arg + 1 >= argc) {
+            cerr << "Error: Missing value for " << flag << endl; // every flag takes a value
+            return 1;  // return error code 1 indicating failure
+        }
+        string value = argv[arg + 1];  // value of the flag
+        long long number = 0;          // value of a numeric flag, negative counts are rejected below
+        bool numeric = flag == "--size" || flag == "--samples" || flag == "--swaps" || flag == "--unique" || flag == "--runs";
+        if ((numeric && !ParseNumber(value, INT_MIN, INT_MAX, number)) ||
+            (flag == "--seed" && !ParseNumber(value, 0, LLONG_MAX, number))) {
+            cerr << "Error: Invalid value for " << flag << ": " << value << endl; // not a number or out of range
+            return 1;  // return error code 1 indicating failure
+        }
+        if (flag == "--dist") {
+            if (!ParseDistribution(value, distribution)) {
+                cerr << "Error: Unknown distribution " << value << endl; // print error message for unknown distributions
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        else if (flag == "--size") {
+            array_size = number;
+        }
+        else if (flag == "--samples") {
+            num_samples = number;
+        }
+        else if (flag == "--seed") {
+            seed = number;
+        }
+        else if (flag == "--swaps") {
+            options.swaps = number;
+        }
+        else if (flag == "--unique") {
+            options.uniqueValues = number;
+        }
+        else if (flag == "--runs") {
+            options.sawtoothRuns = number;
+        }
+        else if (flag == "--format") {
+            if (value != "json" && value != "binary") {
+                cerr << "Error: Unknown format " << value << endl; // print error message for unknown formats
+                return 1;  // return error code 1 indicating failure
+            }
+            binary = value == "binary";
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+    if (array_size < 0 || num_samples < 0 || options.swaps < 0 || options.uniqueValues < 0 || options.sawtoothRuns < 0) {
+        cerr << "Error: --size, --samples, --swaps, --unique and --runs must not be negative" << endl; // nothing sensible to generate
+        return 1;  // return error code 1 indicating failure
+    }
+    
+    try {
+        SampleJsonWriter json_writer;   // used for JSON output
+        SampleFileWriter binary_writer; // used for binary output
+        if (binary) {
+            binary_writer.Open(output_filename, array_size, num_samples);
+        }
+        else {
+            json_writer.Open(output_filename, array_size, num_samples);
+        }
+        
+        // samples are generated and written one at a time, so memory stays at one sample
+        vector<int> sample;  // values of the current sample
+        for (int index = 0; index < num_samples; index++) {
+            string sample_name = "Sample" + to_string(index + 1);  // names as in the existing sample files
+            GenerateSample(distribution, array_size, SampleSeed(seed, index), options, sample);
+            if (binary) {
+                binary_writer.Add(sample_name, sample.data(), sample.size());
+            }
+            else {
+                json_writer.Add(sample_name, sample.data(), sample.size());
+            }
+        }
+        
+        if (binary) {
+            binary_writer.Close();
+        }
+        else {
+            json_writer.Close();
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if the file cannot be written
+        return 1;  // return error code 1 indicating failure
+    }
+    
+    return 0;  // Return 0 :)
+}
@@ -0,0 +1,138 @@
+// Incremental Sort
+//
+// Saved sorted results and their checksums, see incrementalsort.h.
+
+#include "incrementalsort.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+std::string SortStateSidecar(const std::string& filename) {
+   return filename + ".json";
+}
+
+bool SortState::Open(const std::string& filename) {
+   std::string sidecar = SortStateSidecar(filename);
+   std::ifstream file(sidecar);
+   json data;
+
+   entries_.clear();
+   if (!file.is_open()) {
+      return false;   // No state saved yet
+   }
+   try {
+      file >> data;
+   } catch (const json::parse_error&) {
+      throw std::runtime_error("Invalid JSON in file: " + sidecar);
+   }
+   if (!data.contains("samples") || !data["samples"].is_object()) {
+      throw std::runtime_error("Invalid JSON in file: " + sidecar);
+   }
+
+   for (auto& sample : data["samples"].items()) {
+      const json& value = sample.value();
+      SortStateEntry entry;
+      if (!value.is_object() || !value.contains("length") ||
+          !ChecksumFromHex(value.value("inputChecksum", ""), entry.inputChecksum) ||
+          !ChecksumFromHex(value.value("sortedChecksum", ""), entry.sortedChecksum)) {
+         throw std::runtime_error("Invalid JSON in file: " + sidecar);
+      }
+      entry.length = value["length"].get<size_t>();
+      entries_[sample.key()] = entry;
+   }
+   // Results lost since the sidecar was written, nothing can be reused
+   if (!IsBinarySampleFile(filename)) {
+      entries_.clear();
+      return false;
+   }
+
+   // Point every entry at its result, the ones without a matching result are dropped
+   mapped_.Open(filename);
+   std::map<std::string, SortStateEntry> found;
+   for (size_t index = 0; index < mapped_.SampleCount(); ++index) {
+      auto entry = entries_.find(mapped_.Name(index));
+      if (entry != entries_.end() && entry->second.length == mapped_.Size(index)) {
+         entry->second.sorted = mapped_.Data(index);
+         found.insert(*entry);
+      }
+   }
+   entries_.swap(found);
+   return true;
+}
+
+const SortStateEntry* SortState::Find(const std::string& name) const {
+   auto entry = entries_.find(name);
+   return entry != entries_.end() ? &entry->second : nullptr;
+}
+
+SortStateWriter::SortStateWriter() : open_(false) {
+}
+
+SortStateWriter::~SortStateWriter() {
+   // Not closed, most likely because of an error: leave the old state as it was
+   if (open_) {
+      try {
+         samples_.Close();
+      } catch (const std::exception&) {
+         // Nothing to report to from a destructor
+      }
+      std::remove((filename_ + ".tmp").c_str());
+   }
+}
+
+void SortStateWriter::Open(const std::string& filename) {
+   filename_ = filename;
+   entries_.clear();
+   samples_.Open(filename + ".tmp");
+   open_ = true;
+}
+
+void SortStateWriter::Add(const std::string& name, uint64_t inputChecksum, const int* sorted, size_t size) {
+   SortStateEntry entry;
+
+   entry.length = size;
+   entry.inputChecksum = inputChecksum;
+   entry.sortedChecksum = SampleChecksum(sorted, size);
+   entries_[name] = entry;
+   samples_.Add(name, sorted, size);
+}
+
+void SortStateWriter::Close() {
+   std::string sidecar = SortStateSidecar(filename_);
+   json data;
+
+   open_ = false;
+   samples_.SetMetadata(0, (int)entries_.size());
+   samples_.Close();
+
+   data["samples"] = json::object();
+   for (const auto& entry : entries_) {
+      json& value = data["samples"][entry.first];
+      value["length"] = entry.second.length;
+      value["inputChecksum"] = ChecksumToHex(entry.second.inputChecksum);
+      value["sortedChecksum"] = ChecksumToHex(entry.second.sortedChecksum);
+   }
+   {
+      std::ofstream file(sidecar + ".tmp");
+      if (!file.is_open()) {
+         throw std::runtime_error("Cannot write file: " + sidecar);
+      }
+      file << data.dump(4) << std::endl;
+      if (!file) {
+         throw std::runtime_error("Cannot write file: " + sidecar);
+      }
+   }
+
+   /* The results go first. If the sidecar rename is lost, the old sidecar
+    describes results it no longer matches, and the sortedChecksum test in
+    IncrementalSort() turns those samples into full sorts. */
+   if (std::rename((filename_ + ".tmp").c_str(), filename_.c_str()) != 0) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+   if (std::rename((sidecar + ".tmp").c_str(), sidecar.c_str()) != 0) {
+      throw std::runtime_error("Cannot write file: " + sidecar);
+   }
+}
@@ -0,0 +1,124 @@
+#include <iostream>          // for input/output streams (cout, cerr)
+#include <string>            // for using string
+#include <vector>            // for using vector data structure
+#include "samplereader.h"    // include the streaming sample reader
+#include "samplefile.h"      // include the binary sample file writer
+#include "incrementalsort.h" // include the saved sort state
+#include "mergesort.h"       // include the merge sorts
+#include "quicksort.h"       // include the quick sorts
+#include "radixsort.h"       // include the radix sorts
+#include "selector.h"        // include the adaptive sort
+
+using namespace std;          // use standard namespace
+
+// a sort that can sort the whole sample or just the appended values
+struct IncrementalAlgorithm {
+    string name;                           // value of --sort
+    void (*sort)(vector<int>*, NoCount&);  // the uninstrumented sort
+};
+
+const IncrementalAlgorithm INCREMENTAL_ALGORITHMS[] = {
+    {"merge", [](vector<int>* v, NoCount& c) { MergeSortBottomUp(v, c); }},
+    {"quick", [](vector<int>* v, NoCount& c) { QuickSortIntro(v, c); }},
+    {"radix", [](vector<int>* v, NoCount& c) { RadixSort(v, c); }},
+    {"adaptive", [](vector<int>* v, NoCount& c) { Sort(v, c); }},
+};
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be at least 3
+    // program name + input filename + state filename, followed by the optional flags
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <input> <state> [--sort merge|quick|radix|adaptive] [--output FILE]" << endl; // print error message to standard error
+        cerr << "       <state> holds the sorted samples of the last run, it is created if missing and updated" << endl;
+        return 1;  // return error code 1 indicating failure
+    }
+
+    string input_filename = argv[1];  // argv[1] is the sample file to sort
+    string state_filename = argv[2];  // argv[2] is the saved sort state
+    string output_filename;           // optional binary sample file for the sorted samples
+    const IncrementalAlgorithm* algorithm = &INCREMENTAL_ALGORITHMS[3];  // adaptive by default
+    for (int arg = 3; arg < argc; arg++) {
+        string flag = argv[arg];  // name of the flag
+        if (arg + 1 >= argc) {
+            cerr << "Error: Missing value for " << flag << endl; // every flag takes a value
+            return 1;  // return error code 1 indicating failure
+        }
+        string value = argv[++arg];  // value of the flag
+        if (flag == "--sort") {
+            algorithm = nullptr;
+            for (const IncrementalAlgorithm& candidate : INCREMENTAL_ALGORITHMS) {
+                if (candidate.name == value) {
+                    algorithm = &candidate;
+                }
+            }
+            if (algorithm == nullptr) {
+                cerr << "Error: Unknown sort " << value << endl; // print error message for unknown sorts
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        else if (flag == "--output") {
+            output_filename = value;
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+
+    try {
+        // the old state stays mapped while the new one is written next to it
+        SortState state;
+        state.Open(state_filename);
+        SortStateWriter new_state;
+        new_state.Open(state_filename);
+
+        SampleReader reader;
+        reader.Open(input_filename);
+        SampleFileWriter output;
+        if (!output_filename.empty()) {
+            output.Open(output_filename);
+        }
+
+        int modes[NUM_INCREMENTAL_MODES] = {};  // samples handled each way
+        string sample_name;                     // name of the current sample
+        const int* sample_data = nullptr;       // values of the current sample
+        size_t sample_size = 0;                 // number of values in the current sample
+        vector<int> sorted;                     // the sorted sample, reused between samples
+        vector<int> delta;                      // the appended values, reused between samples
+
+        // one CSV row per sample: how it was sorted and how many values had to be sorted
+        cout << "Sample,Mode,Size,Sorted" << endl;
+        while (reader.Next(sample_name, sample_data, sample_size)) {
+            NoCount counter;
+            uint64_t input_checksum = 0;
+            const SortStateEntry* previous = state.Find(sample_name);
+            IncrementalMode mode = IncrementalSort(sample_data, sample_size, previous, algorithm->sort,
+                                                   sorted, delta, counter, input_checksum);
+            modes[mode]++;
+
+            size_t sorted_values = mode == INCREMENTAL_FULL ? sample_size : delta.size();
+            cout << sample_name << "," << INCREMENTAL_MODE_NAMES[mode] << "," << sample_size << ","
+                 << sorted_values << endl;
+
+            new_state.Add(sample_name, input_checksum, sorted.data(), sorted.size());
+            if (!output_filename.empty()) {
+                output.Add(sample_name, sorted.data(), sorted.size());
+            }
+        }
+
+        if (!output_filename.empty()) {
+            output.SetMetadata(reader.Metadata().at("arraySize"), reader.Metadata().at("numSamples"));
+            output.Close();
+        }
+        new_state.Close();  // replaces the old state
+
+        cerr << modes[INCREMENTAL_FULL] << " full, " << modes[INCREMENTAL_APPEND] << " append, "
+             << modes[INCREMENTAL_UNCHANGED] << " unchanged" << endl;  // summary
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if reading or writing fails
+        return 1;  // return error code 1 indicating failure
+    }
+
+    return 0;  // Return 0 :)
+}
@@ -0,0 +1,131 @@
+// Incremental Sort
+//
+// Keeps the sorted result of every sample between runs. A sample that only
+// grew by appends since the last run is brought up to date by sorting the
+// appended values and merging them into the saved result, instead of sorting
+// the whole sample again.
+
+#ifndef INCREMENTALSORT_H
+#define INCREMENTALSORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "checksum.h"
+#include "counting.h"
+#include "mergesort.h"
+#include "samplefile.h"
+
+enum IncrementalMode {
+   INCREMENTAL_FULL,        // No usable saved result, sorted from scratch
+   INCREMENTAL_APPEND,      // Saved input plus appended values, only those were sorted
+   INCREMENTAL_UNCHANGED,   // Same input as the saved result
+   NUM_INCREMENTAL_MODES
+};
+
+const char* const INCREMENTAL_MODE_NAMES[NUM_INCREMENTAL_MODES] = {"full", "append", "unchanged"};
+
+struct SortStateEntry {
+   size_t length = 0;             // Elements in the input and in the sorted result
+   uint64_t inputChecksum = 0;    // Checksum of the input, in input order
+   uint64_t sortedChecksum = 0;   // Checksum of the sorted result
+   const int* sorted = nullptr;   // The sorted result, in the mapped state file
+};
+
+/* The sorted samples of an earlier run. The results are kept in a binary
+ sample file (samplefile.h) and their checksums in a JSON sidecar next to it,
+ <file>.json:
+
+   {"samples": {"<name>": {"inputChecksum": "<hex>", "length": N, "sortedChecksum": "<hex>"}, ...}}
+
+ Entries whose result is missing from the sample file or has another length
+ are dropped. Errors throw runtime_error. */
+class SortState {
+public:
+   // Load the state saved at filename, false if there is none yet
+   bool Open(const std::string& filename);
+
+   // Entry for the sample called name, null if the state has none
+   const SortStateEntry* Find(const std::string& name) const;
+
+   size_t Size() const { return entries_.size(); }
+
+private:
+   MappedSampleFile mapped_;
+   std::map<std::string, SortStateEntry> entries_;
+};
+
+/* Writes a new state one sample at a time. Both files are written under a
+ temporary name and only replace the old state in Close(), so a state that is
+ still mapped by a SortState stays intact while the new one is written, and a
+ writer destroyed without Close() leaves the old state in place. Errors throw
+ runtime_error. */
+class SortStateWriter {
+public:
+   SortStateWriter();
+   ~SortStateWriter();
+
+   void Open(const std::string& filename);
+
+   // Save sorted[0..size-1] as the result for the input with checksum inputChecksum
+   void Add(const std::string& name, uint64_t inputChecksum, const int* sorted, size_t size);
+
+   void Close();
+
+private:
+   std::string filename_;
+   SampleFileWriter samples_;
+   std::map<std::string, SortStateEntry> entries_;
+   bool open_;
+};
+
+// Name of the checksum sidecar of a state file
+std::string SortStateSidecar(const std::string& filename);
+
+/* Sort input[0..size-1] into sorted, reusing previous, the saved result for
+ this sample, when it still applies:
+
+ - If input starts with the input previous was computed from, only the
+   appended input[previous->length..size-1] is copied to delta and sorted with
+   sort, then merged with the saved result by MergeRuns() in one linear pass.
+ - Otherwise the whole input is copied to sorted and sorted with sort.
+
+ The saved result is checked against its sortedChecksum before it is used.
+ inputChecksum is set to the checksum of the whole input, which is computed in
+ the same pass as the prefix check. Checksums are not counted. */
+template <class Counter>
+IncrementalMode IncrementalSort(const int* input, size_t size, const SortStateEntry* previous,
+                                void (*sort)(std::vector<int>* numbers, Counter& counter),
+                                std::vector<int>& sorted, std::vector<int>& delta, Counter& counter,
+                                uint64_t& inputChecksum) {
+   Checksum checksum;
+   bool reuse = false;
+
+   if (previous != nullptr && previous->length <= size) {
+      checksum.Update(input, previous->length);
+      reuse = checksum.Value() == previous->inputChecksum &&
+              SampleChecksum(previous->sorted, previous->length) == previous->sortedChecksum;
+   }
+   checksum.Update(input + checksum.Length(), size - checksum.Length());
+   inputChecksum = checksum.Value();
+
+   if (!reuse) {
+      sorted.assign(input, input + size);
+      sort(&sorted, counter);
+      return INCREMENTAL_FULL;
+   }
+
+   size_t length = previous->length;
+   delta.assign(input + length, input + size);
+   sort(&delta, counter);
+
+   sorted.resize(size);
+   counter.Pass();  // The merge reads the saved result and the delta once
+   MergeRuns((const int*)previous->sorted, (int)length, (const int*)delta.data(), (int)delta.size(),
+             sorted.data(), std::less<int>(), Identity(), counter);
+   return delta.empty() ? INCREMENTAL_UNCHANGED : INCREMENTAL_APPEND;
+}
+
+#endif
@@ -6,24 +6,48 @@
 
 #include "insertionsort.h"
 
-void InsertionSort(std::vector<int>* numbers) {
-   int i = 0;
-   int j = 0;
-   int temp = 0;  // Temporary variable for swap
-   
-   for (i = 1; i < numbers->size(); ++i) {
-      j = i;
-      // Insert numbers[i] into sorted part
-      // stopping once numbers[i] in correct position
-      while (j > 0 && (*numbers)[j] < (*numbers)[j - 1]) {
-         
-         // Swap numbers[j] and numbers[j - 1]
-         temp = (*numbers)[j];
-         (*numbers)[j] = (*numbers)[j - 1];
-         (*numbers)[j - 1] = temp;
-         --j;
-      }
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+void InsertionSort(std::vector<int>* numbers, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   InsertionSort(numbers, counter);
+}
+
+/* Block moves run from the top down so each block is loaded before it is
+ overwritten */
+void InsertionShiftUp(int* numbers, int count) {
+   int pos = count;
+
+#if defined(__AVX2__)
+   while (pos >= 8) {
+      pos -= 8;
+      __m256i block = _mm256_loadu_si256((const __m256i*)(numbers + pos));
+      _mm256_storeu_si256((__m256i*)(numbers + pos + 1), block);
+   }
+#endif
+#if defined(__SSE2__)
+   while (pos >= 4) {
+      pos -= 4;
+      __m128i block = _mm_loadu_si128((const __m128i*)(numbers + pos));
+      _mm_storeu_si128((__m128i*)(numbers + pos + 1), block);
    }
-   
-   return;
-} */
+#endif
+   while (pos > 0) {
+      --pos;
+      numbers[pos + 1] = numbers[pos];
+   }
+}
+
+void InsertionSortRange(int* numbers, int i, int k, int& comp_count, int& mem_count,
+                        bool binary_search) {
+   IntCounts counter(comp_count, mem_count);
+   InsertionSortRange(numbers, i, k, counter, binary_search);
+}
+
+void InsertionSortFast(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       bool binary_search) {
+   IntCounts counter(comp_count, mem_count);
+   InsertionSortFast(numbers, counter, binary_search);
+}
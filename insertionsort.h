@@ -0,0 +1,182 @@
+// Insertion Sort
+//
+// Author: Rob Gysel
+// ECS60, UC Davis
+// Adapted from: Lysecky & Vahid "Data Structures Essentials", zyBooks
+
+#ifndef INSERTIONSORT_H
+#define INSERTIONSORT_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "counting.h"
+#include "projection.h"
+
+/* The sorts are templates on a random-access iterator, a comparator, a
+ projection applied to each element before it is compared, and a counting
+ policy from counting.h. NoCount gives the plain sort, Count64 and
+ PhaseHistogram count it. The std::vector<int>* overloads keep the original
+ interface, and the int& ones count through IntCounts. */
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void InsertionSort(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter) {
+   int size = last - first;
+   int i = 0;
+   int j = 0;
+
+   counter.SetPhase(PHASE_INSERTION);
+   for (i = 1; i < size; ++i) {
+      j = i;
+      // Insert first[i] into sorted part
+      // stopping once first[i] in correct position
+      while (j > 0 && comp(proj(first[j]), proj(first[j - 1]))) {
+         counter.Compare();  // 1 comparison in while condition
+         counter.Access(2);  // 2 memory accesses (read first[j] and first[j - 1])
+
+         // Swap first[j] and first[j - 1]
+         std::iter_swap(first + j, first + (j - 1));
+         counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+         --j;
+      }
+      // Count the final comparison that failed the while loop
+      if (j > 0) {
+         counter.Compare();  // The comparison that made the while condition false
+         counter.Access(2);  // The memory accesses for that final comparison
+      }
+   }
+
+   return;
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void InsertionSort(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   InsertionSort(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void InsertionSort(std::vector<int>* numbers, Counter& counter) {
+   InsertionSort(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(), counter);
+}
+
+void InsertionSort(std::vector<int>* numbers, int& comp_count, int& mem_count);
+
+/* Move numbers[0..count-1] up one position (an overlapping memmove) */
+void InsertionShiftUp(int* numbers, int count);
+
+/* InsertionShiftUp for any element type. Plain int arrays take the
+ vectorized block move. */
+template <class RandomIt>
+void InsertionShift(RandomIt first, int count) {
+   std::move_backward(first, first + count, first + (count + 1));
+}
+
+inline void InsertionShift(int* first, int count) {
+   InsertionShiftUp(first, count);
+}
+
+/* Insert first[start..k] one at a time into the sorted first[i..start-1] */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void InsertionSortFrom(RandomIt first, int i, int start, int k, Compare comp, Proj proj, Counter& counter,
+                       bool binary_search = false) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   int hole = 0;
+   int low = 0;
+   int high = 0;
+   int mid = 0;
+
+   counter.SetPhase(PHASE_INSERTION);
+   for (int pos = start; pos <= k; ++pos) {
+      Value value = std::move(first[pos]);  // 1 memory access (read element to insert)
+      counter.Access();
+
+      if (binary_search) {
+         /* Find the first element in first[i..pos-1] greater than value,
+          so equal elements keep their order */
+         low = i;
+         high = pos;
+         while (low < high) {
+            mid = low + (high - low) / 2;
+            counter.Compare();  // 1 comparison against the probed element
+            counter.Access();   // 1 memory access (read first[mid])
+            if (comp(proj(value), proj(first[mid]))) {
+               high = mid;
+            }
+            else {
+               low = mid + 1;
+            }
+         }
+
+         hole = low;
+         InsertionShift(first + hole, pos - hole);
+         counter.Access(2 * (pos - hole));  // 1 read + 1 write per shifted element
+      }
+      else {
+         hole = pos;
+         while (hole > i) {
+            counter.Compare();  // 1 comparison against the previous element
+            counter.Access();   // 1 memory access (read first[hole - 1])
+            if (!comp(proj(value), proj(first[hole - 1]))) {
+               break;
+            }
+            first[hole] = std::move(first[hole - 1]);
+            counter.Access();   // 1 memory access (write shifted element)
+            --hole;
+         }
+      }
+
+      first[hole] = std::move(value);
+      counter.Access();  // 1 memory access (write inserted element)
+   }
+}
+
+/* InsertionSortFast on first[i..k]. The other sorts use this to finish
+ small partitions and runs. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void InsertionSortRange(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter,
+                        bool binary_search = false) {
+   InsertionSortFrom(first, i, i + 1, k, comp, proj, counter, binary_search);
+}
+
+template <class Counter>
+void InsertionSortRange(int* numbers, int i, int k, Counter& counter, bool binary_search = false) {
+   InsertionSortRange(numbers, i, k, std::less<int>(), Identity(), counter, binary_search);
+}
+
+void InsertionSortRange(int* numbers, int i, int k, int& comp_count, int& mem_count,
+                        bool binary_search = false);
+
+/* Insertion sort that moves the element into a hole instead of swapping.
+ With binary_search the insertion point is found by binary search over the
+ sorted prefix and the tail is shifted up with one block move. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void InsertionSortFast(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       bool binary_search = false) {
+   int size = last - first;
+
+   if (size < 2) {
+      return;
+   }
+
+   InsertionSortRange(first, 0, size - 1, comp, proj, counter, binary_search);
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void InsertionSortFast(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   InsertionSortFast(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void InsertionSortFast(std::vector<int>* numbers, Counter& counter, bool binary_search = false) {
+   InsertionSortFast(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, binary_search);
+}
+
+void InsertionSortFast(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       bool binary_search = false);
+
+#endif
@@ -0,0 +1,47 @@
+#include <iostream>       // for input/output streams (cout, cerr)
+#include <vector>         // for using vector data structure
+#include "json.hpp"       // include the JSON library
+#include "samplereader.h" // include the streaming sample reader
+#include "samplefile.h"   // include the binary sample file writer
+
+using json = nlohmann::json;  // create shortcut for nlohmann::json
+using namespace std;          // use standard namespace
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be 3: program name + input filename + output filename
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <input.json> <output.bin>" << endl; // print error message to standard error
+        return 1;  // return error code 1 indicating failure
+    }
+    
+    string input_filename = argv[1];   // argv[1] is the input JSON filename
+    string output_filename = argv[2];  // argv[2] is the output binary filename
+    
+    try {
+        // open the input, samples are read one at a time below
+        SampleReader reader;
+        reader.Open(input_filename);
+        
+        // the metadata section can come after the samples, so the header is patched on Close()
+        SampleFileWriter writer;
+        writer.Open(output_filename);
+        
+        string sample_name;        // name of the current sample
+        vector<int> sample_array;  // array data of the current sample
+        
+        // copy every sample into the binary file in input order
+        while (reader.Next(sample_name, sample_array)) {
+            writer.Add(sample_name, sample_array.data(), sample_array.size());
+        }
+        
+        // metadata is complete now that every sample has been read
+        writer.SetMetadata(reader.Metadata().at("arraySize"), reader.Metadata().at("numSamples"));
+        writer.Close();
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if reading or writing fails
+        return 1;  // return error code 1 indicating failure
+    }
+    
+    return 0;  // Return 0 :)
+}
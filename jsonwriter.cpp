@@ -0,0 +1,230 @@
+// JSON Writer
+//
+// Streaming JSON output for reports too large to build as a json DOM first.
+
+#include "jsonwriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+// Characters for the longest int, "-2147483648", and the longest long long
+const size_t INT_CHARS = 11;
+const size_t LONG_LONG_CHARS = 20;
+
+// Spaces per indentation level, as json::dump(4)
+const size_t INDENT = 4;
+
+void SortAsKeys(std::vector<size_t>& indexes) {
+   std::sort(indexes.begin(), indexes.end(), [](size_t a, size_t b) {
+      char digitsA[LONG_LONG_CHARS];
+      char digitsB[LONG_LONG_CHARS];
+      char* endA = std::to_chars(digitsA, digitsA + sizeof(digitsA), a).ptr;
+      char* endB = std::to_chars(digitsB, digitsB + sizeof(digitsB), b).ptr;
+      return std::string_view(digitsA, endA - digitsA) < std::string_view(digitsB, endB - digitsB);
+   });
+}
+
+JsonWriter::JsonWriter(std::ostream& output, bool pretty)
+   : output_(output), pretty_(pretty), after_key_(false), buffer_(JSON_WRITER_BUFFER), used_(0) {
+}
+
+JsonWriter::~JsonWriter() {
+   // The outermost EndObject()/EndArray() has flushed a finished document
+   if (!stack_.empty()) {
+      Abandon();
+   }
+}
+
+void JsonWriter::BeginObject() {
+   BeforeValue();
+   Put('{');
+   stack_.push_back({true});
+}
+
+void JsonWriter::EndObject() {
+   End('}');
+}
+
+void JsonWriter::BeginArray() {
+   BeforeValue();
+   Put('[');
+   stack_.push_back({true});
+}
+
+void JsonWriter::EndArray() {
+   End(']');
+}
+
+void JsonWriter::Key(const std::string& key) {
+   Level& level = stack_.back();
+   if (!level.empty) {
+      Put(',');
+   }
+   level.empty = false;
+   Newline(stack_.size());
+   PutString(key);
+   Put(':');
+   if (pretty_) {
+      Put(' ');
+   }
+   after_key_ = true;
+}
+
+void JsonWriter::Key(size_t index) {
+   char digits[LONG_LONG_CHARS];
+   char* end = std::to_chars(digits, digits + sizeof(digits), index).ptr;
+   Key(std::string(digits, end));
+}
+
+void JsonWriter::Int(long long value) {
+   BeforeValue();
+   PutInt(value);
+}
+
+void JsonWriter::UInt(unsigned long long value) {
+   BeforeValue();
+   Reserve(LONG_LONG_CHARS);
+   used_ = std::to_chars(&buffer_[used_], &buffer_[used_] + LONG_LONG_CHARS, value).ptr - buffer_.data();
+}
+
+void JsonWriter::String(const std::string& value) {
+   BeforeValue();
+   PutString(value);
+}
+
+void JsonWriter::IntArray(const int* data, size_t size) {
+   BeginArray();
+   if (size > 0) {
+      stack_.back().empty = false;
+   }
+
+   // Each element is a separator, its indent and at most INT_CHARS digits
+   size_t indent = pretty_ ? 1 + stack_.size() * INDENT : 0;
+   size_t element = 1 + indent + INT_CHARS;
+   for (size_t pos = 0; pos < size; ++pos) {
+      Reserve(element);
+      char* out = &buffer_[used_];
+      if (pos > 0) {
+         *out++ = ',';
+      }
+      if (pretty_) {
+         *out++ = '\n';
+         std::memset(out, ' ', indent - 1);
+         out += indent - 1;
+      }
+      out = std::to_chars(out, out + INT_CHARS, data[pos]).ptr;
+      used_ = out - buffer_.data();
+   }
+   EndArray();
+}
+
+void JsonWriter::Flush() {
+   if (used_ > 0) {
+      output_.write(buffer_.data(), used_);
+      used_ = 0;
+   }
+   output_.flush();
+   if (!output_) {
+      throw std::runtime_error("Cannot write output");
+   }
+}
+
+void JsonWriter::Abandon() {
+   used_ = 0;
+   stack_.clear();
+   after_key_ = false;
+}
+
+void JsonWriter::BeforeValue() {
+   // A value in an object follows its key on the same line
+   if (after_key_) {
+      after_key_ = false;
+      return;
+   }
+   if (stack_.empty()) {
+      return;   // The document itself
+   }
+   Level& level = stack_.back();
+   if (!level.empty) {
+      Put(',');
+   }
+   level.empty = false;
+   Newline(stack_.size());
+}
+
+void JsonWriter::Newline(size_t depth) {
+   if (!pretty_) {
+      return;
+   }
+   Reserve(1 + depth * INDENT);
+   buffer_[used_++] = '\n';
+   std::memset(&buffer_[used_], ' ', depth * INDENT);
+   used_ += depth * INDENT;
+}
+
+void JsonWriter::Reserve(size_t bytes) {
+   if (used_ + bytes > buffer_.size()) {
+      output_.write(buffer_.data(), used_);
+      used_ = 0;
+      if (!output_) {
+         throw std::runtime_error("Cannot write output");
+      }
+      if (bytes > buffer_.size()) {
+         buffer_.resize(bytes);   // A string longer than the whole buffer
+      }
+   }
+}
+
+void JsonWriter::PutInt(long long value) {
+   Reserve(LONG_LONG_CHARS);
+   used_ = std::to_chars(&buffer_[used_], &buffer_[used_] + LONG_LONG_CHARS, value).ptr - buffer_.data();
+}
+
+void JsonWriter::PutString(const std::string& value) {
+   static const char HEX[] = "0123456789abcdef";
+
+   // Escapes as json::dump() does, anything else is copied as is
+   Reserve(2 + value.size() * 6);
+   char* out = &buffer_[used_];
+   *out++ = '"';
+   for (unsigned char c : value) {
+      switch (c) {
+         case '"':  *out++ = '\\'; *out++ = '"'; break;
+         case '\\': *out++ = '\\'; *out++ = '\\'; break;
+         case '\b': *out++ = '\\'; *out++ = 'b'; break;
+         case '\f': *out++ = '\\'; *out++ = 'f'; break;
+         case '\n': *out++ = '\\'; *out++ = 'n'; break;
+         case '\r': *out++ = '\\'; *out++ = 'r'; break;
+         case '\t': *out++ = '\\'; *out++ = 't'; break;
+         default:
+            if (c < 0x20) {
+               std::memcpy(out, "\\u00", 4);
+               out[4] = HEX[c >> 4];
+               out[5] = HEX[c & 0xf];
+               out += 6;
+            }
+            else {
+               *out++ = c;
+            }
+      }
+   }
+   *out++ = '"';
+   used_ = out - buffer_.data();
+}
+
+void JsonWriter::End(char close) {
+   Level level = stack_.back();
+   stack_.pop_back();
+   if (!level.empty) {
+      Newline(stack_.size());
+   }
+   Put(close);
+
+   // The document is complete
+   if (stack_.empty()) {
+      Put('\n');
+      Flush();
+   }
+}
@@ -0,0 +1,80 @@
+// JSON Writer
+//
+// Streaming JSON output for reports too large to build as a json DOM first.
+// Values go straight into a large buffer as they are produced, integers are
+// formatted with std::to_chars.
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Bytes buffered before a write to the output stream
+const size_t JSON_WRITER_BUFFER = 1 << 20;
+
+/* Sort indexes into the order of their Key(size_t) strings, "10" before "9",
+ which is the order the json DOM writes such keys in */
+void SortAsKeys(std::vector<size_t>& indexes);
+
+/* Writes one JSON document to output. Objects and arrays are opened and closed
+ in document order and every value inside an object is preceded by Key().
+ Pretty output is laid out exactly like json::dump(4); compact output like
+ json::dump(), with no whitespace at all. Keys are written in the order they
+ are given, not sorted as the json DOM sorts them. Errors throw runtime_error. */
+class JsonWriter {
+public:
+   explicit JsonWriter(std::ostream& output, bool pretty = true);
+   ~JsonWriter();
+
+   JsonWriter(const JsonWriter&) = delete;
+   JsonWriter& operator=(const JsonWriter&) = delete;
+
+   void BeginObject();
+   void EndObject();
+   void BeginArray();
+   void EndArray();
+
+   void Key(const std::string& key);
+   void Key(size_t index);   // Index as a string key, "12"
+
+   void Int(long long value);
+   void UInt(unsigned long long value);
+   void String(const std::string& value);
+
+   // Array of data[0..size-1], the fast path for sample arrays
+   void IntArray(const int* data, size_t size);
+
+   /* Write what is buffered to the output stream. EndObject()/EndArray() of
+    the outermost value add the closing newline and flush on their own. */
+   void Flush();
+
+   /* Drop what is buffered, for a document cut short by an error. Whatever
+    already went to the output stream stays there. The destructor does the
+    same for a document that was never closed. */
+   void Abandon();
+
+private:
+   void BeforeValue();   // Separator and indent for the next value
+   void Newline(size_t depth);
+   void Reserve(size_t bytes);
+   void Put(char c) { Reserve(1); buffer_[used_++] = c; }
+   void PutInt(long long value);
+   void PutString(const std::string& value);
+   void End(char close);
+
+   struct Level {
+      bool empty;   // Nothing written in this container yet
+   };
+
+   std::ostream& output_;
+   bool pretty_;
+   bool after_key_;           // A key was written, its value comes next
+   std::vector<Level> stack_;
+   std::vector<char> buffer_;
+   size_t used_;
+};
+
+#endif
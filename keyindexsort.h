@@ -0,0 +1,107 @@
+// Key Index Sort
+//
+// Sorts wide records by moving only a compact array of (key, index) pairs
+// during the sort, then moving each record once into its final slot.
+
+#ifndef KEYINDEXSORT_H
+#define KEYINDEXSORT_H
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "counting.h"
+#include "projection.h"
+#include "quicksort.h"
+
+/* Projected key of a record and the record's position in the input */
+template <class Key>
+struct KeyIndex {
+   Key key;
+   int index = 0;
+};
+
+/* Orders KeyIndex entries by key under comp, breaking ties by input index.
+ Every pair of entries is then distinct, so any sort of them is stable. */
+template <class Compare>
+struct KeyIndexLess {
+   Compare comp;
+
+   template <class Key>
+   bool operator()(const KeyIndex<Key>& a, const KeyIndex<Key>& b) const {
+      if (comp(a.key, b.key)) {
+         return true;
+      }
+      return !comp(b.key, a.key) && a.index < b.index;
+   }
+};
+
+/* Put first[0..size-1] in the order given by order, where order[pos] is the
+ input position of the record that belongs at pos. Cycles of the permutation
+ are followed so every record is moved once, plus one temporary per cycle.
+ order is used as the visited marker and is left as the identity. */
+template <class RandomIt, class Counter>
+void ApplyPermutation(RandomIt first, std::vector<int>& order, Counter& counter) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   int size = order.size();
+
+   counter.SetPhase(PHASE_COPY);
+   for (int start = 0; start < size; ++start) {
+      if (order[start] == start) {
+         continue;  // Already in place, or placed by an earlier cycle
+      }
+
+      Value temp = std::move(first[start]);
+      counter.Access(2);  // 1 read + 1 write into temp
+      int pos = start;
+      while (order[pos] != start) {
+         int next = order[pos];
+         first[pos] = std::move(first[next]);
+         counter.Access(2);  // 1 read + 1 write
+         order[pos] = pos;
+         pos = next;
+      }
+      first[pos] = std::move(temp);
+      counter.Access(2);  // 1 read + 1 write from temp
+      order[pos] = pos;
+   }
+}
+
+/* Stable sort of [first, last) by proj(record) under comp. The keys are
+ copied into a KeyIndex array and introsorted there, so partitioning moves
+ only keys, and the records are then permuted into place with
+ ApplyPermutation(). Worth it when records are much wider than keys. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void KeyIndexSort(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter) {
+   typedef typename std::decay<decltype(proj(*first))>::type Key;
+   int size = last - first;
+   std::vector<KeyIndex<Key>> keys(size);
+   std::vector<int> order(size);
+
+   if (size < 2) {
+      return;
+   }
+
+   counter.SetPhase(PHASE_COPY);
+   for (int pos = 0; pos < size; ++pos) {
+      keys[pos].key = proj(first[pos]);
+      keys[pos].index = pos;
+      counter.Access(2);  // 1 read + 1 write
+   }
+
+   QuickSortIntro(keys.begin(), keys.end(), KeyIndexLess<Compare>{comp}, Identity(), counter);
+
+   for (int pos = 0; pos < size; ++pos) {
+      order[pos] = keys[pos].index;
+   }
+   ApplyPermutation(first, order, counter);
+}
+
+template <class RandomIt, class Compare, class Proj>
+void KeyIndexSort(RandomIt first, RandomIt last, Compare comp, Proj proj) {
+   NoCount counter;
+   KeyIndexSort(first, last, comp, proj, counter);
+}
+
+#endif
@@ -6,68 +6,53 @@
 
 #include "mergesort.h"
 
-void MergeSort(std::vector<int>* numbers) {
-   MergeSortRecurse(numbers, 0, numbers->size() - 1);
+void MergeSort(std::vector<int>* numbers, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   MergeSort(numbers, counter);
 }
 
+void MergeSortRecurse(std::vector<int>* numbers, int i, int k, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   MergeSortRecurse(numbers->data(), i, k, std::less<int>(), Identity(), counter);
+}
+
+void Merge(std::vector<int>* numbers, int i, int j, int k, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   Merge(numbers->data(), i, j, k, std::less<int>(), Identity(), counter);
+}
+
+void MergeSortBuffered(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       std::vector<int>* scratch) {
+   IntCounts counter(comp_count, mem_count);
+   MergeSortBuffered(numbers, counter, scratch);
+}
+
+void MergeSortBottomUp(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       std::vector<int>* scratch) {
+   IntCounts counter(comp_count, mem_count);
+   MergeSortBottomUp(numbers, counter, scratch);
+}
+
+void MergeSortMultiway(std::vector<int>* numbers, int& comp_count, int& mem_count, int& pass_count,
+                       int fanIn, int blockSize, std::vector<int>* scratch) {
+   Count64 counter;  // The loser trees need their own default-constructed counters
+
+   MergeSortMultiway(numbers, counter, fanIn, blockSize, scratch);
+   comp_count += counter.comp_count;
+   mem_count += counter.mem_count;
+   pass_count += counter.pass_count;
+}
 
-void MergeSortRecurse(std::vector<int>* numbers, int i, int k) {
-   int j = 0;
-   
-   if (i < k) {
-      j = (i + k) / 2;  // Find the midpoint in the partition
-      
-      // Recursively sort left and right partitions
-      MergeSortRecurse(numbers, i, j);
-      MergeSortRecurse(numbers, j + 1, k);
-      
-      // Merge left and right partition in sorted order
-      Merge(numbers, i, j, k);
-   }
+void MergeSortNatural(std::vector<int>* numbers, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   MergeSortNatural(numbers, counter);
 }
 
-void Merge(std::vector<int>* numbers, int i, int j, int k) {
-   int mergedSize = k - i + 1;                // Size of merged partition
-   int mergePos = 0;                          // Position to insert merged number
-   int leftPos = 0;                           // Position of elements in left partition
-   int rightPos = 0;                          // Position of elements in right partition
-   std::vector<int> mergedNumbers;
-   mergedNumbers.resize(mergedSize);          // Dynamically allocates temporary array
-                                              // for merged numbers
-   
-   leftPos = i;                               // Initialize left partition position
-   rightPos = j + 1;                          // Initialize right partition position
-   
-   // Add smallest element from left or right partition to merged numbers
-   while (leftPos <= j && rightPos <= k) {
-      if ((*numbers)[leftPos] < (*numbers)[rightPos]) {
-         mergedNumbers[mergePos] = (*numbers)[leftPos];
-         ++leftPos;
-      }
-      else {
-         mergedNumbers[mergePos] = (*numbers)[rightPos];
-         ++rightPos;
-         
-      }
-      ++mergePos;
-   }
-   
-   // If left partition is not empty, add remaining elements to merged numbers
-   while (leftPos <= j) {
-      mergedNumbers[mergePos] = (*numbers)[leftPos];
-      ++leftPos;
-      ++mergePos;
-   }
-   
-   // If right partition is not empty, add remaining elements to merged numbers
-   while (rightPos <= k) {
-      mergedNumbers[mergePos] = (*numbers)[rightPos];
-      ++rightPos;
-      ++mergePos;
-   }
-   
-   // Copy merge number back to numbers
-   for (mergePos = 0; mergePos < mergedSize; ++mergePos) {
-      (*numbers)[i + mergePos] = mergedNumbers[mergePos];
-   }
-} 
+void MergeSortParallel(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       int num_threads, int grain) {
+   Count64 counter;  // Tasks need their own default-constructed counters
+
+   MergeSortParallel(numbers, counter, num_threads, grain);
+   comp_count += counter.comp_count;
+   mem_count += counter.mem_count;
+}
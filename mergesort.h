@@ -0,0 +1,1283 @@
+// Merge Sort
+//
+// Author: Rob Gysel
+// ECS60, UC Davis
+// Adapted from: Lysecky & Vahid "Data Structures Essentials", zyBooks
+
+#ifndef MERGESORT_H
+#define MERGESORT_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "counting.h"
+#include "insertionsort.h"
+#include "losertree.h"
+#include "projection.h"
+#include "threadpool.h"
+
+// Runs shorter than this are insertion sorted before the bottom-up merge passes
+const int MERGE_RUN_CUTOFF = 32;
+
+// Ranges larger than this are split and merged across threads by MergeSortParallel
+const int MERGESORT_PARALLEL_GRAIN = 1 << 14;
+
+// Blocks MergeSortMultiway sorts in cache first, 128 KB of ints: the block and
+// its half of the scratch buffer fit together in a 256 KB L2
+const int MULTIWAY_BLOCK_SIZE = 1 << 15;
+
+// Runs MergeSortMultiway merges per pass. Every run being read holds a cache
+// line and a page, so the pass stays well inside the L1 and the L1 TLB
+const int MULTIWAY_FAN_IN = 16;
+
+/* Every sort is a template on an iterator, comparator, projection and counting
+ policy (see insertionsort.h), with std::vector<int>* and int& overloads that
+ keep the original interface. Scratch buffers hold the iterator's value type,
+ which must be default constructible. */
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void Merge(RandomIt first, int i, int j, int k, Compare comp, Proj proj, Counter& counter) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   int mergedSize = k - i + 1;                // Size of merged partition
+   int mergePos = 0;                          // Position to insert merged number
+   int leftPos = 0;                           // Position of elements in left partition
+   int rightPos = 0;                          // Position of elements in right partition
+   std::vector<Value> mergedNumbers;
+   mergedNumbers.resize(mergedSize);          // Dynamically allocates temporary array
+                                              // for merged numbers
+
+   leftPos = i;                               // Initialize left partition position
+   rightPos = j + 1;                          // Initialize right partition position
+
+   counter.SetPhase(PHASE_MERGE);
+
+   // Add smallest element from left or right partition to merged numbers
+   while (leftPos <= j && rightPos <= k) {
+      counter.Compare();  // 1 comparison of left and right element
+      counter.Access(2);  // 2 memory accesses (read first[leftPos] and first[rightPos])
+      if (comp(proj(first[leftPos]), proj(first[rightPos]))) {
+         mergedNumbers[mergePos] = std::move(first[leftPos]);
+         ++leftPos;
+      }
+      else {
+         mergedNumbers[mergePos] = std::move(first[rightPos]);
+         ++rightPos;
+
+      }
+      counter.Access(2);  // 1 read + 1 write into merged numbers
+      ++mergePos;
+   }
+
+   // If left partition is not empty, add remaining elements to merged numbers
+   while (leftPos <= j) {
+      mergedNumbers[mergePos] = std::move(first[leftPos]);
+      counter.Access(2);  // 1 read + 1 write
+      ++leftPos;
+      ++mergePos;
+   }
+
+   // If right partition is not empty, add remaining elements to merged numbers
+   while (rightPos <= k) {
+      mergedNumbers[mergePos] = std::move(first[rightPos]);
+      counter.Access(2);  // 1 read + 1 write
+      ++rightPos;
+      ++mergePos;
+   }
+
+   // Copy merge number back to numbers
+   counter.SetPhase(PHASE_COPY);
+   for (mergePos = 0; mergePos < mergedSize; ++mergePos) {
+      first[i + mergePos] = std::move(mergedNumbers[mergePos]);
+      counter.Access(2);  // 1 read + 1 write
+   }
+}
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortRecurse(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   int j = 0;
+
+   if (i < k) {
+      j = (i + k) / 2;  // Find the midpoint in the partition
+
+      // Recursively sort left and right partitions
+      MergeSortRecurse(first, i, j, comp, proj, counter);
+      MergeSortRecurse(first, j + 1, k, comp, proj, counter);
+
+      // Merge left and right partition in sorted order
+      Merge(first, i, j, k, comp, proj, counter);
+   }
+}
+
+/* Levels of a two-way merge sort of size elements, ceil(log2(size)). Each
+ level streams the whole range through memory at least once. */
+inline int MergeLevels(int size) {
+   int levels = 0;
+   while (size > (1 << levels) && levels < 31) {
+      ++levels;
+   }
+   return levels;
+}
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSort(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter) {
+   counter.Pass(2 * MergeLevels(last - first));  // Every level merges into a temporary and copies back
+   MergeSortRecurse(first, 0, (int)(last - first) - 1, comp, proj, counter);
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSort(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSort(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSort(std::vector<int>* numbers, Counter& counter) {
+   MergeSort(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(), counter);
+}
+
+void MergeSort(std::vector<int>* numbers, int& comp_count, int& mem_count);
+void MergeSortRecurse(std::vector<int>* numbers, int i, int k, int& comp_count, int& mem_count);
+void Merge(std::vector<int>* numbers, int i, int j, int k, int& comp_count, int& mem_count);
+
+/* Merge the sorted runs left[0..leftSize-1] and right[0..rightSize-1] into dst.
+ Counts are kept the same way as Merge() so the two are comparable. */
+template <class InputIt, class OutputIt, class Compare, class Proj, class Counter>
+void MergeRuns(InputIt left, int leftSize, InputIt right, int rightSize, OutputIt dst,
+               Compare comp, Proj proj, Counter& counter) {
+   int leftPos = 0;
+   int rightPos = 0;
+   int mergePos = 0;
+
+   counter.SetPhase(PHASE_MERGE);
+   while (leftPos < leftSize && rightPos < rightSize) {
+      counter.Compare();  // 1 comparison of left and right element
+      counter.Access(2);  // 2 memory accesses (read left[leftPos] and right[rightPos])
+      if (comp(proj(left[leftPos]), proj(right[rightPos]))) {
+         dst[mergePos] = std::move(left[leftPos]);
+         ++leftPos;
+      }
+      else {
+         dst[mergePos] = std::move(right[rightPos]);
+         ++rightPos;
+      }
+      counter.Access(2);  // 1 read + 1 write into dst
+      ++mergePos;
+   }
+
+   while (leftPos < leftSize) {
+      dst[mergePos] = std::move(left[leftPos]);
+      counter.Access(2);  // 1 read + 1 write
+      ++leftPos;
+      ++mergePos;
+   }
+
+   while (rightPos < rightSize) {
+      dst[mergePos] = std::move(right[rightPos]);
+      counter.Access(2);  // 1 read + 1 write
+      ++rightPos;
+      ++mergePos;
+   }
+}
+
+/* Merge the sorted runs src[i..j] and src[j+1..k] into dst[i..k] */
+template <class InputIt, class OutputIt, class Compare, class Proj, class Counter>
+void MergeInto(InputIt src, OutputIt dst, int i, int j, int k, Compare comp, Proj proj, Counter& counter) {
+   MergeRuns(src + i, j - i + 1, src + (j + 1), k - j, dst + i, comp, proj, counter);
+}
+
+/* Copy count elements of src into dst */
+template <class InputIt, class OutputIt, class Counter>
+void MergeCopy(InputIt src, OutputIt dst, int count, Counter& counter) {
+   counter.SetPhase(PHASE_COPY);
+   for (int pos = 0; pos < count; ++pos) {
+      dst[pos] = src[pos];
+      counter.Access(2);  // 1 read + 1 write
+   }
+}
+
+/* Sort src[i..k] into dst[i..k]. Both arrays hold the same values on entry,
+ so the halves are sorted back into src and then merged into dst. Every
+ element is read from one array before the other is written at its
+ position, so the merges may move instead of copy. */
+template <class SrcIt, class DstIt, class Compare, class Proj, class Counter>
+void MergeSortSplit(SrcIt src, DstIt dst, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   int j = 0;
+
+   if (i >= k) {
+      return;  // 1 element is already in place in both arrays
+   }
+
+   j = i + (k - i) / 2;  // Find the midpoint in the partition
+
+   // Sort each half into src, swapping the roles of the two arrays
+   MergeSortSplit(dst, src, i, j, comp, proj, counter);
+   MergeSortSplit(dst, src, j + 1, k, comp, proj, counter);
+
+   // Merge the sorted halves from src into dst
+   MergeInto(src, dst, i, j, k, comp, proj, counter);
+}
+
+/* Allocation-free merge sort. One scratch buffer the size of the range is
+ used for the whole sort; pass one in to reuse it across calls. Source and
+ destination alternate between levels so no copy-back pass is needed. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortBuffered(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       std::vector<typename std::iterator_traits<RandomIt>::value_type>* scratch = nullptr) {
+   int size = last - first;
+   std::vector<typename std::iterator_traits<RandomIt>::value_type> localScratch;
+
+   if (size < 2) {
+      return;
+   }
+
+   // Use the caller's buffer when given, growing it only if it is too small
+   if (scratch == nullptr) {
+      scratch = &localScratch;
+   }
+   if ((int)scratch->size() < size) {
+      scratch->resize(size);
+   }
+
+   // Seed the scratch buffer with a copy so both arrays start out equal
+   MergeCopy(first, scratch->data(), size, counter);
+
+   counter.Pass(1 + MergeLevels(size));  // The copy, then one merge per level
+   MergeSortSplit(scratch->data(), first, 0, size - 1, comp, proj, counter);
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSortBuffered(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSortBuffered(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSortBuffered(std::vector<int>* numbers, Counter& counter, std::vector<int>* scratch = nullptr) {
+   MergeSortBuffered(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, scratch);
+}
+
+void MergeSortBuffered(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       std::vector<int>* scratch = nullptr);
+
+/* One bottom-up pass: merge adjacent runs of width elements from src into dst */
+template <class SrcIt, class DstIt, class Compare, class Proj, class Counter>
+void MergePass(SrcIt src, DstIt dst, int size, int width, Compare comp, Proj proj, Counter& counter) {
+   for (int i = 0; i < size; i += 2 * width) {
+      int j = i + width - 1;
+      int k = i + 2 * width - 1;
+
+      if (j >= size - 1) {
+         // No right run left in this pass, carry the left run over as is
+         MergeCopy(src + i, dst + i, size - i, counter);
+         break;
+      }
+      if (k > size - 1) {
+         k = size - 1;
+      }
+      MergeInto(src, dst, i, j, k, comp, proj, counter);
+   }
+}
+
+/* Iterative bottom-up merge sort. Runs of MERGE_RUN_CUTOFF elements are
+ insertion sorted in place, then merged pairwise with doubling width. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortBottomUp(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       std::vector<typename std::iterator_traits<RandomIt>::value_type>* scratch = nullptr) {
+   int size = last - first;
+   std::vector<typename std::iterator_traits<RandomIt>::value_type> localScratch;
+
+   if (size < 2) {
+      return;
+   }
+
+   // Sort short runs in place first so the merge passes start at a wider width
+   counter.Pass();
+   for (int i = 0; i < size; i += MERGE_RUN_CUTOFF) {
+      int k = i + MERGE_RUN_CUTOFF - 1;
+      if (k > size - 1) {
+         k = size - 1;
+      }
+      InsertionSortRange(first, i, k, comp, proj, counter);
+   }
+
+   if (size <= MERGE_RUN_CUTOFF) {
+      return;  // A single run needs no merging
+   }
+
+   if (scratch == nullptr) {
+      scratch = &localScratch;
+   }
+   if ((int)scratch->size() < size) {
+      scratch->resize(size);
+   }
+
+   // Merge passes alternate between the range and the scratch buffer
+   for (int width = MERGE_RUN_CUTOFF; width < size; width *= 4) {
+      MergePass(first, scratch->data(), size, width, comp, proj, counter);
+      counter.Pass();
+
+      // An odd number of passes leaves the result in the scratch buffer
+      if (2 * width >= size) {
+         MergeCopy(scratch->data(), first, size, counter);
+         counter.Pass();
+         break;
+      }
+      MergePass(scratch->data(), first, size, 2 * width, comp, proj, counter);
+      counter.Pass();
+   }
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSortBottomUp(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSortBottomUp(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSortBottomUp(std::vector<int>* numbers, Counter& counter, std::vector<int>* scratch = nullptr) {
+   MergeSortBottomUp(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, scratch);
+}
+
+void MergeSortBottomUp(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       std::vector<int>* scratch = nullptr);
+
+/* Merge the count sorted runs src[bounds[r]..bounds[r + 1] - 1] into
+ dst[bounds[0]..bounds[count] - 1] with a loser tree, about log2(count)
+ compares per element. Ties go to the earlier run, so the merge is stable.
+ When a run runs dry the tree is rebuilt over the runs that are left, so
+ every replay takes the tree's fast path, and the last run is copied over.
+ The trees count into their own default-constructed Counters, which are
+ added to counter. */
+template <class SrcIt, class DstIt, class Compare, class Proj, class Counter>
+void MergeRunsMultiway(SrcIt src, DstIt dst, const int* bounds, int count, Compare comp, Proj proj,
+                       Counter& counter) {
+   typedef typename std::iterator_traits<SrcIt>::value_type Value;
+   auto less = [comp, proj](const Value& a, const Value& b) { return comp(proj(a), proj(b)); };
+   std::vector<int> heads(bounds, bounds + count);  // Next unmerged position of each run
+   std::vector<int> live;                           // Runs with elements left, in run order
+   int mergePos = bounds[0];
+   int run = 0;
+   int winner = 0;
+
+   for (run = 0; run < count; ++run) {
+      if (heads[run] < bounds[run + 1]) {
+         live.push_back(run);
+      }
+   }
+
+   while (live.size() > 1) {
+      LoserTree<Value, decltype(less), Counter> tree(live.size(), less);
+      for (int source = 0; source < (int)live.size(); ++source) {
+         tree.Set(source, src[heads[live[source]]]);
+      }
+      tree.Build();
+
+      // Merge until the winning run runs dry
+      counter.SetPhase(PHASE_MERGE);
+      while (true) {
+         winner = tree.Winner();
+         run = live[winner];
+         dst[mergePos] = tree.WinnerValue();
+         counter.Access(2);  // 1 read of the run head + 1 write into dst
+         ++mergePos;
+         if (++heads[run] == bounds[run + 1]) {
+            break;
+         }
+         tree.Replace(src[heads[run]]);
+      }
+
+      counter.Add(tree.Counts());
+      live.erase(live.begin() + winner);
+   }
+
+   if (!live.empty()) {
+      run = live[0];
+      MergeCopy(src + heads[run], dst + mergePos, bounds[run + 1] - heads[run], counter);
+   }
+}
+
+/* One multiway pass: merge each group of fanIn adjacent runs of width
+ elements from src into dst */
+template <class SrcIt, class DstIt, class Compare, class Proj, class Counter>
+void MultiwayPass(SrcIt src, DstIt dst, int size, long long width, int fanIn, Compare comp, Proj proj,
+                  Counter& counter) {
+   std::vector<int> bounds(fanIn + 1);
+   long long start = 0;
+   int count = 0;
+
+   for (long long i = 0; i < size; i += width * fanIn) {
+      count = 0;
+      for (start = i; start < size && count < fanIn; start += width) {
+         bounds[count++] = start;
+      }
+      bounds[count] = start < size ? start : size;
+
+      if (count == 1) {
+         // A lone run at the end of this pass, carry it over as is
+         MergeCopy(src + i, dst + i, size - i, counter);
+         break;
+      }
+      MergeRunsMultiway(src, dst, bounds.data(), count, comp, proj, counter);
+   }
+}
+
+/* Sort first[0..size-1] bottom-up as MergeSortBottomUp does, with
+ buffer[0..size-1] as scratch, for a block that fits in cache. The passes
+ alternate between the two, returns true if the sorted block ended up in
+ buffer. */
+template <class RandomIt, class BufferIt, class Compare, class Proj, class Counter>
+bool MergeSortBlock(RandomIt first, BufferIt buffer, int size, Compare comp, Proj proj, Counter& counter) {
+   bool inBuffer = false;
+
+   for (int i = 0; i < size; i += MERGE_RUN_CUTOFF) {
+      int k = i + MERGE_RUN_CUTOFF - 1;
+      if (k > size - 1) {
+         k = size - 1;
+      }
+      InsertionSortRange(first, i, k, comp, proj, counter);
+   }
+
+   for (int width = MERGE_RUN_CUTOFF; width < size; width *= 2) {
+      if (inBuffer) {
+         MergePass(buffer, first, size, width, comp, proj, counter);
+      }
+      else {
+         MergePass(first, buffer, size, width, comp, proj, counter);
+      }
+      inBuffer = !inBuffer;
+   }
+   return inBuffer;
+}
+
+/* Cache-blocked multiway merge sort for ranges much larger than the cache.
+ Blocks of blockSize elements are sorted while they are in cache, then fanIn
+ runs at a time are merged with a loser tree, so the range streams through
+ memory 1 + ceil(log_fanIn(size / blockSize)) times instead of once or twice
+ per level of a two-way merge; counter.Pass() counts them. The blocks are
+ sorted into whichever array lets the last merge pass end in the range, so
+ nothing is copied back. The merges count into default-constructed Counters,
+ as MergeSortParallel does. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortMultiway(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       int fanIn = MULTIWAY_FAN_IN, int blockSize = MULTIWAY_BLOCK_SIZE,
+                       std::vector<typename std::iterator_traits<RandomIt>::value_type>* scratch = nullptr) {
+   int size = last - first;
+   std::vector<typename std::iterator_traits<RandomIt>::value_type> localScratch;
+   int passes = 0;
+   int pass = 0;
+   long long width = 0;
+
+   if (size < 2) {
+      return;
+   }
+   if (fanIn < 2) {
+      fanIn = 2;
+   }
+   if (blockSize < 1) {
+      blockSize = 1;
+   }
+
+   if (scratch == nullptr) {
+      scratch = &localScratch;
+   }
+   if ((int)scratch->size() < size) {
+      scratch->resize(size);
+   }
+
+   // Merge passes needed once the blocks are sorted
+   for (width = blockSize; width < size; width *= fanIn) {
+      ++passes;
+   }
+
+   // Sort each block while it is in cache, and leave it in the array the
+   // first merge pass reads from. The copy is only needed when the block's
+   // own passes end in the other one, and the block is still in cache then
+   counter.Pass();
+   for (int i = 0; i < size; i += blockSize) {
+      int length = size - i > blockSize ? blockSize : size - i;
+      bool inScratch = MergeSortBlock(first + i, scratch->data() + i, length, comp, proj, counter);
+      if (inScratch && passes % 2 == 0) {
+         MergeCopy(scratch->data() + i, first + i, length, counter);
+      }
+      else if (!inScratch && passes % 2 == 1) {
+         MergeCopy(first + i, scratch->data() + i, length, counter);
+      }
+   }
+
+   // Merge passes alternate between the two arrays and end in the range
+   for (width = blockSize, pass = 0; pass < passes; width *= fanIn, ++pass) {
+      if ((passes - pass) % 2 == 0) {
+         MultiwayPass(first, scratch->data(), size, width, fanIn, comp, proj, counter);
+      }
+      else {
+         MultiwayPass(scratch->data(), first, size, width, fanIn, comp, proj, counter);
+      }
+      counter.Pass();
+   }
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSortMultiway(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSortMultiway(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSortMultiway(std::vector<int>* numbers, Counter& counter, int fanIn = MULTIWAY_FAN_IN,
+                       int blockSize = MULTIWAY_BLOCK_SIZE, std::vector<int>* scratch = nullptr) {
+   MergeSortMultiway(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, fanIn, blockSize, scratch);
+}
+
+/* Unlike the older int& entry points this one also reports its passes over
+ the array, the number the multiway merge exists to bring down */
+void MergeSortMultiway(std::vector<int>* numbers, int& comp_count, int& mem_count, int& pass_count,
+                       int fanIn = MULTIWAY_FAN_IN, int blockSize = MULTIWAY_BLOCK_SIZE,
+                       std::vector<int>* scratch = nullptr);
+
+// Natural merge sort extends runs shorter than this (halved, see NaturalMinRun) by binary insertion
+const int NATURAL_MIN_MERGE = 32;
+
+// Wins in a row by one run before a natural merge starts galloping
+const int NATURAL_MIN_GALLOP = 7;
+
+/* Minimum run length for size elements, between NATURAL_MIN_MERGE / 2 and
+ NATURAL_MIN_MERGE. Chosen so size / minRun is a power of two or just under
+ one, which keeps the final merges balanced. */
+inline int NaturalMinRun(int size) {
+   int extra = 0;
+
+   while (size >= NATURAL_MIN_MERGE) {
+      extra |= size & 1;
+      size >>= 1;
+   }
+   return size + extra;
+}
+
+/* Length of the run starting at first[lo] and ending before first[hi]. A
+ strictly descending run is reversed in place; strict, so reversing never
+ reorders equal elements. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+int NaturalRunLength(RandomIt first, int lo, int hi, Compare comp, Proj proj, Counter& counter) {
+   int runHi = lo + 1;
+
+   if (runHi == hi) {
+      return 1;
+   }
+
+   counter.SetPhase(PHASE_RUNS);
+   counter.Compare();  // 1 comparison of the first two elements
+   counter.Access(2);  // 2 memory accesses (read both)
+   if (comp(proj(first[runHi]), proj(first[lo]))) {
+      ++runHi;
+      while (runHi < hi) {
+         counter.Compare();  // 1 comparison with the previous element
+         counter.Access(2);  // 2 memory accesses (read both)
+         if (!comp(proj(first[runHi]), proj(first[runHi - 1]))) {
+            break;
+         }
+         ++runHi;
+      }
+      std::reverse(first + lo, first + runHi);
+      counter.Access(4 * ((runHi - lo) / 2));  // 4 memory accesses per swap
+   }
+   else {
+      ++runHi;
+      while (runHi < hi) {
+         counter.Compare();  // 1 comparison with the previous element
+         counter.Access(2);  // 2 memory accesses (read both)
+         if (comp(proj(first[runHi]), proj(first[runHi - 1]))) {
+            break;
+         }
+         ++runHi;
+      }
+   }
+
+   return runHi - lo;
+}
+
+/* Position of key in the sorted a[0..len-1], searching outward from a[hint]
+ in steps of 1, 3, 7, ... and then by binary search between the last two
+ probes. GallopLeft returns the first position whose element is not less
+ than key, GallopRight the first whose element is greater than key. */
+template <class Key, class It, class Compare, class Proj, class Counter>
+int GallopLeft(const Key& key, It a, int len, int hint, Compare comp, Proj proj, Counter& counter) {
+   int lastOfs = 0;
+   int ofs = 1;
+   int maxOfs = 0;
+   int temp = 0;
+
+   counter.Compare();  // 1 comparison with a[hint]
+   counter.Access();   // 1 memory access (read a[hint])
+   if (comp(proj(a[hint]), key)) {
+      // Gallop right until a[hint + lastOfs] < key <= a[hint + ofs]
+      maxOfs = len - hint;
+      while (ofs < maxOfs) {
+         counter.Compare();  // 1 comparison with the probed element
+         counter.Access();   // 1 memory access (read it)
+         if (!comp(proj(a[hint + ofs]), key)) {
+            break;
+         }
+         lastOfs = ofs;
+         ofs = (ofs << 1) + 1;
+         if (ofs <= 0) {
+            ofs = maxOfs;  // int overflow
+         }
+      }
+      if (ofs > maxOfs) {
+         ofs = maxOfs;
+      }
+      lastOfs += hint;
+      ofs += hint;
+   }
+   else {
+      // Gallop left until a[hint - ofs] < key <= a[hint - lastOfs]
+      maxOfs = hint + 1;
+      while (ofs < maxOfs) {
+         counter.Compare();  // 1 comparison with the probed element
+         counter.Access();   // 1 memory access (read it)
+         if (comp(proj(a[hint - ofs]), key)) {
+            break;
+         }
+         lastOfs = ofs;
+         ofs = (ofs << 1) + 1;
+         if (ofs <= 0) {
+            ofs = maxOfs;
+         }
+      }
+      if (ofs > maxOfs) {
+         ofs = maxOfs;
+      }
+      temp = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - temp;
+   }
+
+   // Now a[lastOfs] < key <= a[ofs], binary search what is left in between
+   ++lastOfs;
+   while (lastOfs < ofs) {
+      int mid = lastOfs + (ofs - lastOfs) / 2;
+      counter.Compare();  // 1 comparison with the probed element
+      counter.Access();   // 1 memory access (read it)
+      if (comp(proj(a[mid]), key)) {
+         lastOfs = mid + 1;
+      }
+      else {
+         ofs = mid;
+      }
+   }
+   return ofs;
+}
+
+template <class Key, class It, class Compare, class Proj, class Counter>
+int GallopRight(const Key& key, It a, int len, int hint, Compare comp, Proj proj, Counter& counter) {
+   int lastOfs = 0;
+   int ofs = 1;
+   int maxOfs = 0;
+   int temp = 0;
+
+   counter.Compare();  // 1 comparison with a[hint]
+   counter.Access();   // 1 memory access (read a[hint])
+   if (comp(key, proj(a[hint]))) {
+      // Gallop left until a[hint - ofs] <= key < a[hint - lastOfs]
+      maxOfs = hint + 1;
+      while (ofs < maxOfs) {
+         counter.Compare();  // 1 comparison with the probed element
+         counter.Access();   // 1 memory access (read it)
+         if (!comp(key, proj(a[hint - ofs]))) {
+            break;
+         }
+         lastOfs = ofs;
+         ofs = (ofs << 1) + 1;
+         if (ofs <= 0) {
+            ofs = maxOfs;
+         }
+      }
+      if (ofs > maxOfs) {
+         ofs = maxOfs;
+      }
+      temp = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - temp;
+   }
+   else {
+      // Gallop right until a[hint + lastOfs] <= key < a[hint + ofs]
+      maxOfs = len - hint;
+      while (ofs < maxOfs) {
+         counter.Compare();  // 1 comparison with the probed element
+         counter.Access();   // 1 memory access (read it)
+         if (comp(key, proj(a[hint + ofs]))) {
+            break;
+         }
+         lastOfs = ofs;
+         ofs = (ofs << 1) + 1;
+         if (ofs <= 0) {
+            ofs = maxOfs;
+         }
+      }
+      if (ofs > maxOfs) {
+         ofs = maxOfs;
+      }
+      lastOfs += hint;
+      ofs += hint;
+   }
+
+   // Now a[lastOfs] <= key < a[ofs], binary search what is left in between
+   ++lastOfs;
+   while (lastOfs < ofs) {
+      int mid = lastOfs + (ofs - lastOfs) / 2;
+      counter.Compare();  // 1 comparison with the probed element
+      counter.Access();   // 1 memory access (read it)
+      if (comp(key, proj(a[mid]))) {
+         ofs = mid;
+      }
+      else {
+         lastOfs = mid + 1;
+      }
+   }
+   return ofs;
+}
+
+/* State of one natural merge sort: the pending runs and the scratch buffer.
+ Runs on the stack satisfy len[i - 2] > len[i - 1] + len[i] and
+ len[i - 1] > len[i], so the stack stays O(log n) deep and merges stay
+ balanced. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+class NaturalMerger {
+public:
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+
+   NaturalMerger(RandomIt first, Compare comp, Proj proj, Counter& counter)
+      : first_(first), comp_(comp), proj_(proj), counter_(counter), minGallop_(NATURAL_MIN_GALLOP) {}
+
+   void PushRun(int base, int len) {
+      runBase_.push_back(base);
+      runLen_.push_back(len);
+   }
+
+   // Merge until the stack invariants hold again
+   void MergeCollapse() {
+      while (runLen_.size() > 1) {
+         int n = runLen_.size() - 2;
+         if ((n > 0 && runLen_[n - 1] <= runLen_[n] + runLen_[n + 1]) ||
+             (n > 1 && runLen_[n - 2] <= runLen_[n - 1] + runLen_[n])) {
+            if (runLen_[n - 1] < runLen_[n + 1]) {
+               --n;
+            }
+         }
+         else if (runLen_[n] > runLen_[n + 1]) {
+            break;
+         }
+         MergeAt(n);
+      }
+   }
+
+   // Merge every run left on the stack, once the input is used up
+   void MergeForceCollapse() {
+      while (runLen_.size() > 1) {
+         int n = runLen_.size() - 2;
+         if (n > 0 && runLen_[n - 1] < runLen_[n + 1]) {
+            --n;
+         }
+         MergeAt(n);
+      }
+   }
+
+private:
+   // Move count elements from src to dst, front to back
+   template <class SrcIt, class DstIt>
+   void MoveBlock(SrcIt src, DstIt dst, int count) {
+      std::move(src, src + count, dst);
+      counter_.Access(2 * count);  // 1 read + 1 write per element
+   }
+
+   /* Merge runs n and n + 1. Elements of run n already below run n + 1 and
+    elements of run n + 1 already above run n are found by galloping and left
+    where they are. */
+   void MergeAt(int n) {
+      int base1 = runBase_[n];
+      int len1 = runLen_[n];
+      int base2 = runBase_[n + 1];
+      int len2 = runLen_[n + 1];
+      int skip = 0;
+
+      runLen_[n] = len1 + len2;
+      runBase_.erase(runBase_.begin() + n + 1);
+      runLen_.erase(runLen_.begin() + n + 1);
+
+      counter_.SetPhase(PHASE_MERGE);
+      skip = GallopRight(proj_(first_[base2]), first_ + base1, len1, 0, comp_, proj_, counter_);
+      base1 += skip;
+      len1 -= skip;
+      if (len1 == 0) {
+         return;  // Already in order, the common case for presorted input
+      }
+
+      len2 = GallopLeft(proj_(first_[base1 + len1 - 1]), first_ + base2, len2, len2 - 1, comp_, proj_, counter_);
+      if (len2 == 0) {
+         return;
+      }
+
+      if (len1 <= len2) {
+         MergeLo(base1, len1, base2, len2);
+      }
+      else {
+         MergeHi(base1, len1, base2, len2);
+      }
+   }
+
+   /* Merge front to back with the left run, the smaller one, in scratch.
+    first[base1] > first[base2] and the left run ends above the right run. */
+   void MergeLo(int base1, int len1, int base2, int len2) {
+      Value* tmp = nullptr;
+      int cursor1 = 0;
+      int cursor2 = base2;
+      int dest = base1;
+      int minGallop = minGallop_;
+      bool done = false;
+
+      tmp_.resize(len1 > (int)tmp_.size() ? len1 : tmp_.size());
+      tmp = tmp_.data();
+      MoveBlock(first_ + base1, tmp, len1);
+
+      first_[dest++] = std::move(first_[cursor2++]);
+      counter_.Access(2);  // 1 read + 1 write
+      if (--len2 == 0) {
+         MoveBlock(tmp + cursor1, first_ + dest, len1);
+         return;
+      }
+      if (len1 == 1) {
+         MoveBlock(first_ + cursor2, first_ + dest, len2);
+         first_[dest + len2] = std::move(tmp[cursor1]);
+         counter_.Access(2);  // 1 read + 1 write
+         return;
+      }
+
+      while (!done) {
+         int count1 = 0;  // Wins in a row by the left run
+         int count2 = 0;  // Wins in a row by the right run
+
+         // One element at a time until one run keeps winning
+         while (!done && (count1 | count2) < minGallop) {
+            counter_.Compare();  // 1 comparison of left and right element
+            counter_.Access(2);  // 2 memory accesses (read both)
+            if (comp_(proj_(first_[cursor2]), proj_(tmp[cursor1]))) {
+               first_[dest++] = std::move(first_[cursor2++]);
+               counter_.Access(2);  // 1 read + 1 write
+               ++count2;
+               count1 = 0;
+               done = --len2 == 0;
+            }
+            else {
+               first_[dest++] = std::move(tmp[cursor1++]);
+               counter_.Access(2);  // 1 read + 1 write
+               ++count1;
+               count2 = 0;
+               done = --len1 == 1;
+            }
+         }
+
+         // Gallop: find how far each run wins and move whole blocks
+         while (!done) {
+            count1 = GallopRight(proj_(first_[cursor2]), tmp + cursor1, len1, 0, comp_, proj_, counter_);
+            if (count1 != 0) {
+               MoveBlock(tmp + cursor1, first_ + dest, count1);
+               dest += count1;
+               cursor1 += count1;
+               len1 -= count1;
+               if (len1 <= 1) {
+                  done = true;
+                  break;
+               }
+            }
+            first_[dest++] = std::move(first_[cursor2++]);
+            counter_.Access(2);  // 1 read + 1 write
+            if (--len2 == 0) {
+               done = true;
+               break;
+            }
+
+            count2 = GallopLeft(proj_(tmp[cursor1]), first_ + cursor2, len2, 0, comp_, proj_, counter_);
+            if (count2 != 0) {
+               MoveBlock(first_ + cursor2, first_ + dest, count2);
+               dest += count2;
+               cursor2 += count2;
+               len2 -= count2;
+               if (len2 == 0) {
+                  done = true;
+                  break;
+               }
+            }
+            first_[dest++] = std::move(tmp[cursor1++]);
+            counter_.Access(2);  // 1 read + 1 write
+            if (--len1 == 1) {
+               done = true;
+               break;
+            }
+
+            // Galloping pays off, make it easier to enter next time
+            --minGallop;
+            if (count1 < NATURAL_MIN_GALLOP && count2 < NATURAL_MIN_GALLOP) {
+               break;
+            }
+         }
+         if (!done) {
+            if (minGallop < 0) {
+               minGallop = 0;
+            }
+            minGallop += 2;  // Penalty for leaving gallop mode
+         }
+      }
+      minGallop_ = minGallop < 1 ? 1 : minGallop;
+
+      if (len1 == 1) {
+         // The last left element is the largest of both runs
+         MoveBlock(first_ + cursor2, first_ + dest, len2);
+         first_[dest + len2] = std::move(tmp[cursor1]);
+         counter_.Access(2);  // 1 read + 1 write
+      }
+      else {
+         MoveBlock(tmp + cursor1, first_ + dest, len1);
+      }
+   }
+
+   /* Merge back to front with the right run, the smaller one, in scratch.
+    first[base1] > first[base2] and the left run ends above the right run. */
+   void MergeHi(int base1, int len1, int base2, int len2) {
+      Value* tmp = nullptr;
+      int cursor1 = base1 + len1 - 1;
+      int cursor2 = len2 - 1;
+      int dest = base2 + len2 - 1;
+      int minGallop = minGallop_;
+      bool done = false;
+
+      tmp_.resize(len2 > (int)tmp_.size() ? len2 : tmp_.size());
+      tmp = tmp_.data();
+      MoveBlock(first_ + base2, tmp, len2);
+
+      first_[dest--] = std::move(first_[cursor1--]);
+      counter_.Access(2);  // 1 read + 1 write
+      if (--len1 == 0) {
+         MoveBlock(tmp, first_ + (dest - (len2 - 1)), len2);
+         return;
+      }
+      if (len2 == 1) {
+         dest -= len1;
+         cursor1 -= len1;
+         MoveBackward(first_ + (cursor1 + 1), first_ + (dest + 1), len1);
+         first_[dest] = std::move(tmp[cursor2]);
+         counter_.Access(2);  // 1 read + 1 write
+         return;
+      }
+
+      while (!done) {
+         int count1 = 0;  // Wins in a row by the left run
+         int count2 = 0;  // Wins in a row by the right run
+
+         while (!done && (count1 | count2) < minGallop) {
+            counter_.Compare();  // 1 comparison of left and right element
+            counter_.Access(2);  // 2 memory accesses (read both)
+            if (comp_(proj_(tmp[cursor2]), proj_(first_[cursor1]))) {
+               first_[dest--] = std::move(first_[cursor1--]);
+               counter_.Access(2);  // 1 read + 1 write
+               ++count1;
+               count2 = 0;
+               done = --len1 == 0;
+            }
+            else {
+               first_[dest--] = std::move(tmp[cursor2--]);
+               counter_.Access(2);  // 1 read + 1 write
+               ++count2;
+               count1 = 0;
+               done = --len2 == 1;
+            }
+         }
+
+         while (!done) {
+            count1 = len1 - GallopRight(proj_(tmp[cursor2]), first_ + base1, len1, len1 - 1,
+                                        comp_, proj_, counter_);
+            if (count1 != 0) {
+               dest -= count1;
+               cursor1 -= count1;
+               len1 -= count1;
+               MoveBackward(first_ + (cursor1 + 1), first_ + (dest + 1), count1);
+               if (len1 == 0) {
+                  done = true;
+                  break;
+               }
+            }
+            first_[dest--] = std::move(tmp[cursor2--]);
+            counter_.Access(2);  // 1 read + 1 write
+            if (--len2 == 1) {
+               done = true;
+               break;
+            }
+
+            count2 = len2 - GallopLeft(proj_(first_[cursor1]), tmp, len2, len2 - 1, comp_, proj_, counter_);
+            if (count2 != 0) {
+               dest -= count2;
+               cursor2 -= count2;
+               len2 -= count2;
+               MoveBlock(tmp + (cursor2 + 1), first_ + (dest + 1), count2);
+               if (len2 <= 1) {
+                  done = true;
+                  break;
+               }
+            }
+            first_[dest--] = std::move(first_[cursor1--]);
+            counter_.Access(2);  // 1 read + 1 write
+            if (--len1 == 0) {
+               done = true;
+               break;
+            }
+
+            --minGallop;
+            if (count1 < NATURAL_MIN_GALLOP && count2 < NATURAL_MIN_GALLOP) {
+               break;
+            }
+         }
+         if (!done) {
+            if (minGallop < 0) {
+               minGallop = 0;
+            }
+            minGallop += 2;
+         }
+      }
+      minGallop_ = minGallop < 1 ? 1 : minGallop;
+
+      if (len2 == 1) {
+         // The first right element is the smallest of both runs
+         dest -= len1;
+         cursor1 -= len1;
+         MoveBackward(first_ + (cursor1 + 1), first_ + (dest + 1), len1);
+         first_[dest] = std::move(tmp[cursor2]);
+         counter_.Access(2);  // 1 read + 1 write
+      }
+      else {
+         MoveBlock(tmp, first_ + (dest - (len2 - 1)), len2);
+      }
+   }
+
+   // Move count elements from src to dst, back to front, for overlapping moves to the right
+   void MoveBackward(RandomIt src, RandomIt dst, int count) {
+      std::move_backward(src, src + count, dst + count);
+      counter_.Access(2 * count);  // 1 read + 1 write per element
+   }
+
+   RandomIt first_;
+   Compare comp_;
+   Proj proj_;
+   Counter& counter_;
+   int minGallop_;
+   std::vector<Value> tmp_;
+   std::vector<int> runBase_;
+   std::vector<int> runLen_;
+};
+
+/* TimSort-style natural merge sort. Ascending and strictly descending runs
+ already in the input are found and kept (descending ones reversed), runs
+ shorter than NaturalMinRun() are extended by binary insertion, and the runs
+ are merged from a balanced run stack, galloping when one run keeps winning.
+ Sorted or strictly descending input takes n - 1 compares. Stable. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortNatural(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter) {
+   int size = last - first;
+   int lo = 0;
+   int remaining = size;
+   int minRun = 0;
+   int runLen = 0;
+
+   if (size < 2) {
+      return;
+   }
+
+   // Small inputs are one run extended by binary insertion
+   if (size < NATURAL_MIN_MERGE) {
+      runLen = NaturalRunLength(first, 0, size, comp, proj, counter);
+      InsertionSortFrom(first, 0, runLen, size - 1, comp, proj, counter, true);
+      return;
+   }
+
+   NaturalMerger<RandomIt, Compare, Proj, Counter> merger(first, comp, proj, counter);
+   minRun = NaturalMinRun(size);
+   while (remaining > 0) {
+      runLen = NaturalRunLength(first, lo, size, comp, proj, counter);
+
+      // Extend a short run to minRun elements (or the rest of the input)
+      if (runLen < minRun) {
+         int force = remaining <= minRun ? remaining : minRun;
+         InsertionSortFrom(first, lo, lo + runLen, lo + force - 1, comp, proj, counter, true);
+         runLen = force;
+      }
+
+      merger.PushRun(lo, runLen);
+      merger.MergeCollapse();
+      lo += runLen;
+      remaining -= runLen;
+   }
+
+   merger.MergeForceCollapse();
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSortNatural(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSortNatural(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSortNatural(std::vector<int>* numbers, Counter& counter) {
+   MergeSortNatural(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(), counter);
+}
+
+void MergeSortNatural(std::vector<int>* numbers, int& comp_count, int& mem_count);
+
+/* Number of elements the first count outputs of merging left and right take
+ from left (the co-rank of count). Found by binary search, so a merge can be
+ cut at any output position without scanning either run. */
+template <class InputIt, class Compare, class Proj, class Counter>
+int MergeCoRank(InputIt left, int leftSize, InputIt right, int rightSize, int count,
+                Compare comp, Proj proj, Counter& counter) {
+   int low = count > rightSize ? count - rightSize : 0;
+   int high = count < leftSize ? count : leftSize;
+   int mid = 0;
+
+   counter.SetPhase(PHASE_MERGE);
+   while (low < high) {
+      mid = low + (high - low) / 2;
+      counter.Compare();  // 1 comparison of the two candidate boundary elements
+      counter.Access(2);  // 2 memory accesses (read left[mid] and right[count - mid - 1])
+      if (comp(proj(left[mid]), proj(right[count - mid - 1]))) {
+         low = mid + 1;  // left[mid] belongs in the first part too
+      }
+      else {
+         high = mid;
+      }
+   }
+
+   return low;
+}
+
+template <class InputIt, class OutputIt, class Compare, class Proj, class Counter>
+void MergeRunsParallel(InputIt left, int leftSize, InputIt right, int rightSize, OutputIt dst,
+                       Compare comp, Proj proj, int grain, ThreadPool& pool,
+                       ThreadCounters<Counter>& counters) {
+   Counter counter;
+   int half = (leftSize + rightSize) / 2;
+   int leftHalf = 0;
+
+   if (leftSize + rightSize <= grain || leftSize == 0 || rightSize == 0) {
+      MergeRuns(left, leftSize, right, rightSize, dst, comp, proj, counter);
+      counters.Add(counter);
+      return;
+   }
+
+   // Cut both runs where the first half of the output ends
+   leftHalf = MergeCoRank(left, leftSize, right, rightSize, half, comp, proj, counter);
+   counters.Add(counter);
+
+   TaskGroup group(pool);
+   group.Run([=, &pool, &counters] {
+      MergeRunsParallel(left, leftHalf, right, half - leftHalf, dst, comp, proj, grain, pool, counters);
+   });
+   MergeRunsParallel(left + leftHalf, leftSize - leftHalf, right + (half - leftHalf),
+                     rightSize - (half - leftHalf), dst + half, comp, proj, grain, pool, counters);
+   group.Wait();
+}
+
+/* Parallel MergeSortSplit(), same source and destination roles */
+template <class SrcIt, class DstIt, class Compare, class Proj, class Counter>
+void MergeSortParallelSplit(SrcIt src, DstIt dst, int i, int k, Compare comp, Proj proj, int grain,
+                            ThreadPool& pool, ThreadCounters<Counter>& counters) {
+   Counter counter;
+   int j = 0;
+
+   if (k - i + 1 <= grain) {
+      MergeSortSplit(src, dst, i, k, comp, proj, counter);
+      counters.Add(counter);
+      return;
+   }
+
+   j = i + (k - i) / 2;  // Find the midpoint in the partition
+
+   {
+      TaskGroup group(pool);
+      group.Run([=, &pool, &counters] {
+         MergeSortParallelSplit(dst, src, i, j, comp, proj, grain, pool, counters);
+      });
+      MergeSortParallelSplit(dst, src, j + 1, k, comp, proj, grain, pool, counters);
+      group.Wait();
+   }
+
+   MergeRunsParallel(src + i, j - i + 1, src + (j + 1), k - j, dst + i, comp, proj, grain, pool, counters);
+}
+
+/* Parallel MergeSortBuffered on a work-stealing pool of num_threads threads
+ (0 for one per hardware thread). Halves above grain are sorted as separate
+ tasks, and large merges are split by a binary search for the co-rank of the
+ output midpoint so both pieces merge in parallel. Each task counts into its
+ own Counter and the per-thread totals are added to counter at the end, so
+ Counter must be default constructible. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortParallel(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       int num_threads = 0, int grain = MERGESORT_PARALLEL_GRAIN) {
+   int size = last - first;
+
+   if (size <= grain || num_threads == 1) {
+      MergeSortBuffered(first, last, comp, proj, counter);
+      return;
+   }
+
+   ThreadPool pool(num_threads);
+   MergeSortParallel(first, last, comp, proj, counter, pool, grain);
+}
+
+// MergeSortParallel on an existing pool
+template <class RandomIt, class Compare, class Proj, class Counter>
+void MergeSortParallel(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       ThreadPool& pool, int grain = MERGESORT_PARALLEL_GRAIN) {
+   int size = last - first;
+   std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+
+   if (size <= grain) {
+      MergeSortBuffered(first, last, comp, proj, counter);
+      return;
+   }
+
+   scratch.resize(size);
+   MergeCopy(first, scratch.data(), size, counter);
+
+   ThreadCounters<Counter> counters(pool);
+   MergeSortParallelSplit(scratch.data(), first, 0, size - 1, comp, proj, grain, pool, counters);
+
+   counter.Add(counters.Total());
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void MergeSortParallel(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   MergeSortParallel(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void MergeSortParallel(std::vector<int>* numbers, Counter& counter,
+                       int num_threads = 0, int grain = MERGESORT_PARALLEL_GRAIN) {
+   MergeSortParallel(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, num_threads, grain);
+}
+
+void MergeSortParallel(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       int num_threads = 0, int grain = MERGESORT_PARALLEL_GRAIN);
+
+template <class Counter>
+void MergeSortParallel(std::vector<int>* numbers, Counter& counter, ThreadPool& pool,
+                       int grain = MERGESORT_PARALLEL_GRAIN) {
+   MergeSortParallel(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, pool, grain);
+}
+
+#endif
@@ -0,0 +1,157 @@
+// Perf Counters
+//
+// Hardware and software event counters from perf_event_open(2), read around
+// a sort call to show what the hand counts miss: cycles, instructions, branch
+// misses, cache misses and page faults.
+
+#include "perfcounters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+/* Type and config of each PerfEvent */
+static void EventConfig(PerfEvent event, perf_event_attr& attr) {
+   switch (event) {
+      case PERF_CYCLES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_CPU_CYCLES;
+         break;
+      case PERF_INSTRUCTIONS:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+         break;
+      case PERF_BRANCH_MISSES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+         break;
+      case PERF_L1D_MISSES:
+         attr.type = PERF_TYPE_HW_CACHE;
+         attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                       | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+         break;
+      case PERF_LLC_MISSES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_CACHE_MISSES;
+         break;
+      default:
+         attr.type = PERF_TYPE_SOFTWARE;
+         attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+         break;
+   }
+}
+#endif
+
+PerfCounters::PerfCounters() {
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      fds_[event] = -1;
+   }
+}
+
+PerfCounters::~PerfCounters() {
+   Close();
+}
+
+bool PerfCounters::Open() {
+   bool opened = false;
+
+   Close();
+   error_.clear();
+#ifdef __linux__
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      EventConfig((PerfEvent)event, attr);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;  // Allowed at the default perf_event_paranoid level
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      // This thread on any CPU
+      fds_[event] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fds_[event] >= 0) {
+         opened = true;
+      }
+      else if (error_.empty()) {
+         error_ = std::string(PERF_EVENT_NAMES[event]) + ": " + strerror(errno);
+      }
+   }
+#else
+   error_ = "perf_event_open is only available on Linux";
+#endif
+   return opened;
+}
+
+void PerfCounters::Close() {
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+#ifdef __linux__
+      if (fds_[event] >= 0) {
+         close(fds_[event]);
+      }
+#endif
+      fds_[event] = -1;
+   }
+}
+
+void PerfCounters::Reset() {
+#ifdef __linux__
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      if (fds_[event] >= 0) {
+         ioctl(fds_[event], PERF_EVENT_IOC_RESET, 0);
+      }
+   }
+#endif
+}
+
+void PerfCounters::Start() {
+#ifdef __linux__
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      if (fds_[event] >= 0) {
+         ioctl(fds_[event], PERF_EVENT_IOC_ENABLE, 0);
+      }
+   }
+#endif
+}
+
+void PerfCounters::Stop() {
+#ifdef __linux__
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      if (fds_[event] >= 0) {
+         ioctl(fds_[event], PERF_EVENT_IOC_DISABLE, 0);
+      }
+   }
+#endif
+}
+
+PerfReading PerfCounters::Read() const {
+   PerfReading reading;
+
+#ifdef __linux__
+   for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+      uint64_t data[3] = {};  // value, time enabled, time running
+
+      if (fds_[event] < 0 || read(fds_[event], data, sizeof(data)) != (ssize_t)sizeof(data)) {
+         continue;
+      }
+      if (data[1] > 0 && data[2] == 0) {
+         continue;  // Enabled but never scheduled onto a hardware counter
+      }
+      reading.available[event] = true;
+      reading.values[event] = data[0];
+      if (data[2] > 0 && data[2] < data[1]) {
+         // Multiplexed, extrapolate from the share of the time it was counting
+         reading.values[event] = (long long)((double)data[0] * data[1] / data[2]);
+      }
+   }
+#endif
+   return reading;
+}
@@ -0,0 +1,65 @@
+// Perf Counters
+//
+// Hardware and software event counters from perf_event_open(2), read around
+// a sort call to show what the hand counts miss: cycles, instructions, branch
+// misses, cache misses and page faults.
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+
+enum PerfEvent {
+   PERF_CYCLES,
+   PERF_INSTRUCTIONS,
+   PERF_BRANCH_MISSES,
+   PERF_L1D_MISSES,      // L1 data cache read misses
+   PERF_LLC_MISSES,      // Last-level cache misses
+   PERF_PAGE_FAULTS,
+   NUM_PERF_EVENTS
+};
+
+// CSV column suffixes and JSON keys
+const char* const PERF_EVENT_NAMES[NUM_PERF_EVENTS] = {
+   "Cycles", "Instructions", "BranchMisses", "L1dMisses", "LlcMisses", "PageFaults"
+};
+
+/* Event counts. An event the kernel or hardware would not count is marked
+ unavailable, which leaves its value at 0. */
+struct PerfReading {
+   long long values[NUM_PERF_EVENTS] = {};
+   bool available[NUM_PERF_EVENTS] = {};
+};
+
+/* One counter per event on the calling thread, user space only. Events are
+ opened separately, so a machine without one of them (or a container that
+ allows only the software events) still gets the rest. Counts are scaled up
+ when the kernel had to multiplex the hardware counters. Start() and Stop()
+ accumulate until Reset(). */
+class PerfCounters {
+public:
+   PerfCounters();
+   ~PerfCounters();
+
+   PerfCounters(const PerfCounters&) = delete;
+   PerfCounters& operator=(const PerfCounters&) = delete;
+
+   /* Open the events, returns false if none could be opened. Error() gives
+    the reason for the first event that could not be opened. */
+   bool Open();
+   void Close();
+
+   bool Available(PerfEvent event) const { return fds_[event] >= 0; }
+   const std::string& Error() const { return error_; }
+
+   void Reset();
+   void Start();
+   void Stop();
+   PerfReading Read() const;
+
+private:
+   int fds_[NUM_PERF_EVENTS];
+   std::string error_;
+};
+
+#endif
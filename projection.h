@@ -0,0 +1,15 @@
+// Projection
+//
+// Default projection for the generic sorts. A projection maps an element to
+// the key the comparator sees, so records can be sorted by one field.
+
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+/* Compare the elements themselves */
+struct Identity {
+   template <class T>
+   const T& operator()(const T& value) const { return value; }
+};
+
+#endif
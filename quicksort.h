@@ -0,0 +1,671 @@
+// Quicksort
+//
+// Author: Rob Gysel
+// ECS60, UC Davis
+// Adapted from: Lysecky & Vahid "Data Structures Essentials", zyBooks
+
+#ifndef QUICKSORT_H
+#define QUICKSORT_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "counting.h"
+#include "insertionsort.h"
+#include "projection.h"
+#include "threadpool.h"
+
+// Partitions at or below this size are finished with insertion sort
+const int QUICKSORT_INSERTION_THRESHOLD = 16;
+
+// Partitions at or above this size pick the pivot with Tukey's ninther
+const int QUICKSORT_NINTHER_THRESHOLD = 128;
+
+// Partitions larger than this are handed to other threads by QuickSortParallel
+const int QUICKSORT_PARALLEL_GRAIN = 1 << 14;
+
+// Elements classified at a time by PartitionBlock, at most 256 so offsets fit a byte
+const int QUICKSORT_BLOCK_SIZE = 64;
+
+enum PartitionScheme {
+   PARTITION_HOARE,   // Partition(), branches on every comparison
+   PARTITION_BLOCK    // PartitionBlock(), with PartitionThreeWay() for repeated keys
+};
+
+/* Every sort is a template on an iterator, comparator, projection and counting
+ policy (see insertionsort.h), with std::vector<int>* and int& overloads that
+ keep the original interface. */
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+int Partition(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   int l = 0;
+   int h = 0;
+   int midpoint = 0;
+   bool done = false;
+
+   counter.SetPhase(PHASE_PARTITION);
+
+   /* Pick middle element as pivot */
+   midpoint = i + (k - i) / 2;
+   Value pivot = first[midpoint];  // 1 memory access (read pivot)
+   counter.Access();
+
+   l = i;
+   h = k;
+
+   while (!done) {
+
+      /* Increment l while first[l] < pivot */
+      while (comp(proj(first[l]), proj(pivot))) {
+         counter.Compare();  // 1 comparison in while condition
+         counter.Access();   // 1 memory access (reading first[l])
+         ++l;
+      }
+      // Count the final comparison that failed the while loop
+      counter.Compare();  // The comparison that made the while condition false
+      counter.Access();   // The memory access for that final comparison
+
+      /* Decrement h while pivot < first[h] */
+      while (comp(proj(pivot), proj(first[h]))) {
+         counter.Compare();  // 1 comparison in while condition
+         counter.Access();   // 1 memory access (reading first[h])
+         --h;
+      }
+      // Count the final comparison that failed the while loop
+      counter.Compare();  // The comparison that made the while condition false
+      counter.Access();   // The memory access for that final comparison
+
+      /* If there are zero or one elements remaining,
+       all numbers are partitioned. Return h */
+      if (l >= h) {
+         counter.Compare();  // 1 comparison for the if condition
+         done = true;
+      }
+      else {
+         counter.Compare();  // 1 comparison for the if condition (else case)
+
+         /* Swap first[l] and first[h],
+          update l and h */
+         std::iter_swap(first + l, first + h);
+         counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+
+         ++l;
+         --h;
+      }
+   }
+
+   return h;
+}
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortRecurse(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   int j = 0;
+
+   /* Base case: If there are 1 or zero elements to sort,
+    partition is already sorted */
+   if (i >= k) {
+      return;
+   }
+
+   /* Partition the data within the array. Value j returned
+    from partitioning is location of last element in low partition. */
+   j = Partition(first, i, k, comp, proj, counter);
+
+   /* Recursively sort low partition (i to j) and
+    high partition (j + 1 to k) */
+   QuickSortRecurse(first, i, j, comp, proj, counter);
+   QuickSortRecurse(first, j + 1, k, comp, proj, counter);
+
+   return;
+}
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSort(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter) {
+   QuickSortRecurse(first, 0, (int)(last - first) - 1, comp, proj, counter);
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void QuickSort(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   QuickSort(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void QuickSort(std::vector<int>* numbers, Counter& counter) {
+   QuickSort(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(), counter);
+}
+
+void QuickSort(std::vector<int>* numbers, int& comp_count, int& mem_count);
+void QuickSortRecurse(std::vector<int>* numbers, int i, int k, int& comp_count, int& mem_count);
+int Partition(std::vector<int>* numbers, int i, int k, int& comp_count, int& mem_count);
+
+/* Return the index of the median of first[a], first[b] and first[c] */
+template <class RandomIt, class Compare, class Proj, class Counter>
+int MedianOfThree(RandomIt first, int a, int b, int c, Compare comp, Proj proj, Counter& counter) {
+   const auto& valA = proj(first[a]);
+   const auto& valB = proj(first[b]);
+   const auto& valC = proj(first[c]);
+   counter.Access(3);  // 3 memory accesses (read the three candidates)
+
+   counter.Compare();  // 1 comparison of a and b
+   if (comp(valA, valB)) {
+      counter.Compare();  // 1 comparison of b and c
+      if (comp(valB, valC)) {
+         return b;
+      }
+      counter.Compare();  // 1 comparison of a and c
+      return comp(valA, valC) ? c : a;
+   }
+   counter.Compare();  // 1 comparison of a and c
+   if (comp(valA, valC)) {
+      return a;
+   }
+   counter.Compare();  // 1 comparison of b and c
+   return comp(valB, valC) ? c : b;
+}
+
+/* Pick a pivot for first[i..k] and move it to the midpoint,
+ which is where Partition() takes its pivot from */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void ChoosePivot(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   int size = k - i + 1;
+   int midpoint = i + (k - i) / 2;
+   int pivotPos = 0;
+
+   counter.SetPhase(PHASE_PIVOT);
+   if (size >= QUICKSORT_NINTHER_THRESHOLD) {
+      /* Tukey's ninther: median of the medians of three spread-out triples */
+      int step = size / 8;
+      int a = MedianOfThree(first, i, i + step, i + 2 * step, comp, proj, counter);
+      int b = MedianOfThree(first, midpoint - step, midpoint, midpoint + step, comp, proj, counter);
+      int c = MedianOfThree(first, k - 2 * step, k - step, k, comp, proj, counter);
+      pivotPos = MedianOfThree(first, a, b, c, comp, proj, counter);
+   }
+   else {
+      pivotPos = MedianOfThree(first, i, midpoint, k, comp, proj, counter);
+   }
+
+   if (pivotPos != midpoint) {
+      std::iter_swap(first + pivotPos, first + midpoint);
+      counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+   }
+}
+
+/* Restore the max-heap property of the heap stored at first[i..i+size-1]
+ starting from heap position root */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void SiftDown(RandomIt first, int i, int root, int size, Compare comp, Proj proj, Counter& counter) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   Value value = std::move(first[i + root]);  // 1 memory access (read root value)
+   int child = 0;
+   counter.Access();
+
+   while ((child = 2 * root + 1) < size) {
+      // Pick the larger of the two children
+      if (child + 1 < size) {
+         counter.Compare();  // 1 comparison between the children
+         counter.Access(2);  // 2 memory accesses (read both children)
+         if (comp(proj(first[i + child]), proj(first[i + child + 1]))) {
+            ++child;
+         }
+      }
+
+      counter.Compare();  // 1 comparison of the value against the larger child
+      counter.Access();   // 1 memory access (read larger child)
+      if (!comp(proj(value), proj(first[i + child]))) {
+         break;
+      }
+
+      first[i + root] = std::move(first[i + child]);
+      counter.Access(2);  // 1 read + 1 write to move the child up
+      root = child;
+   }
+
+   first[i + root] = std::move(value);
+   counter.Access();  // 1 memory access (write value into its slot)
+}
+
+/* Heapsort first[i..k], used once a partition has recursed too deep */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void HeapSortRange(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   int size = k - i + 1;
+
+   counter.SetPhase(PHASE_HEAP);
+   for (int root = size / 2 - 1; root >= 0; --root) {
+      SiftDown(first, i, root, size, comp, proj, counter);
+   }
+
+   for (int end = size - 1; end > 0; --end) {
+      // Move the current maximum behind the heap
+      std::iter_swap(first + i, first + (i + end));
+      counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+
+      SiftDown(first, i, 0, end, comp, proj, counter);
+   }
+}
+
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortIntroLoop(RandomIt first, int i, int k, int depth_limit, int insertion_threshold,
+                        Compare comp, Proj proj, Counter& counter) {
+   int j = 0;
+
+   while (k - i + 1 > insertion_threshold) {
+      /* Too many bad splits, finish this partition in guaranteed O(n log n) */
+      if (depth_limit == 0) {
+         HeapSortRange(first, i, k, comp, proj, counter);
+         return;
+      }
+      --depth_limit;
+
+      ChoosePivot(first, i, k, comp, proj, counter);
+      j = Partition(first, i, k, comp, proj, counter);
+
+      /* Recurse into the smaller side and loop on the larger one,
+       which keeps the stack depth at O(log n) */
+      if (j - i < k - j) {
+         QuickSortIntroLoop(first, i, j, depth_limit, insertion_threshold, comp, proj, counter);
+         i = j + 1;
+      }
+      else {
+         QuickSortIntroLoop(first, j + 1, k, depth_limit, insertion_threshold, comp, proj, counter);
+         k = j;
+      }
+   }
+
+   InsertionSortRange(first, i, k, comp, proj, counter);
+}
+
+/* Partition first[i..k] around the pivot at first[i]. Elements are compared
+ against the pivot a block at a time from each end, and the comparison results
+ are stored into offset buffers without branching (BlockQuicksort). The
+ misplaced elements the two buffers point at are then swapped in one batch.
+ Returns the final position p of the pivot: first[i..p-1] < pivot and
+ first[p+1..k] >= pivot. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+int PartitionBlock(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   unsigned char offsetsL[QUICKSORT_BLOCK_SIZE];
+   unsigned char offsetsR[QUICKSORT_BLOCK_SIZE];
+   int numL = 0;
+   int numR = 0;
+   int startL = 0;
+   int startR = 0;
+   int num = 0;
+   int l = i + 1;
+   int r = k;
+
+   counter.SetPhase(PHASE_PARTITION);
+   Value pivot = first[i];  // 1 memory access (read pivot)
+   counter.Access();
+
+   while (r - l + 1 >= 2 * QUICKSORT_BLOCK_SIZE) {
+      /* Offsets of the elements >= pivot in the left block */
+      if (numL == 0) {
+         startL = 0;
+         for (int j = 0; j < QUICKSORT_BLOCK_SIZE; ++j) {
+            offsetsL[numL] = j;
+            numL += !comp(proj(first[l + j]), proj(pivot));
+         }
+         counter.Compare(QUICKSORT_BLOCK_SIZE);  // 1 comparison per element of the block
+         counter.Access(QUICKSORT_BLOCK_SIZE);   // 1 memory access per element of the block
+      }
+      /* Offsets of the elements < pivot in the right block */
+      if (numR == 0) {
+         startR = 0;
+         for (int j = 0; j < QUICKSORT_BLOCK_SIZE; ++j) {
+            offsetsR[numR] = j;
+            numR += comp(proj(first[r - j]), proj(pivot));
+         }
+         counter.Compare(QUICKSORT_BLOCK_SIZE);  // 1 comparison per element of the block
+         counter.Access(QUICKSORT_BLOCK_SIZE);   // 1 memory access per element of the block
+      }
+
+      num = std::min(numL, numR);
+      for (int j = 0; j < num; ++j) {
+         std::iter_swap(first + (l + offsetsL[startL + j]), first + (r - offsetsR[startR + j]));
+      }
+      counter.Access(4 * num);  // Total for each swap: 1 + 2 + 1 = 4 memory accesses
+
+      numL -= num;
+      numR -= num;
+      startL += num;
+      startR += num;
+      if (numL == 0) {
+         l += QUICKSORT_BLOCK_SIZE;
+      }
+      if (numR == 0) {
+         r -= QUICKSORT_BLOCK_SIZE;
+      }
+   }
+
+   /* Fewer than two blocks are left. first[..l-1] < pivot and
+    first[r+1..] >= pivot, so the rest is finished element by element and any
+    offsets still buffered are simply classified again, every comparison
+    counted as in Partition(). */
+   while (true) {
+      while (l <= r && comp(proj(first[l]), proj(pivot))) {
+         counter.Compare();  // 1 comparison in while condition
+         counter.Access();   // 1 memory access (reading first[l])
+         ++l;
+      }
+      // Count the final comparison that failed the while loop, there is none once l > r
+      if (l <= r) {
+         counter.Compare();  // The comparison that made the while condition false
+         counter.Access();   // The memory access for that final comparison
+      }
+      while (l <= r && !comp(proj(first[r]), proj(pivot))) {
+         counter.Compare();  // 1 comparison in while condition
+         counter.Access();   // 1 memory access (reading first[r])
+         --r;
+      }
+      // Count the final comparison that failed the while loop, there is none once l > r
+      if (l <= r) {
+         counter.Compare();  // The comparison that made the while condition false
+         counter.Access();   // The memory access for that final comparison
+      }
+      if (l >= r) {
+         break;
+      }
+      std::iter_swap(first + l, first + r);
+      counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+      ++l;
+      --r;
+   }
+
+   // Move the pivot between the two sides
+   std::iter_swap(first + i, first + (l - 1));
+   counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+   return l - 1;
+}
+
+/* Three-way (fat) partition of first[i..k] around the pivot at first[i]:
+ first[i..lt-1] < pivot, first[lt..gt] equal to it and first[gt+1..k] > pivot.
+ The equal block is final, so repeated keys are never swapped again. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void PartitionThreeWay(RandomIt first, int i, int k, Compare comp, Proj proj, Counter& counter,
+                       int& lt, int& gt) {
+   typedef typename std::iterator_traits<RandomIt>::value_type Value;
+   int pos = i + 1;
+
+   counter.SetPhase(PHASE_PARTITION);
+   Value pivot = first[i];  // 1 memory access (read pivot)
+   counter.Access();
+
+   lt = i;
+   gt = k;
+   while (pos <= gt) {
+      counter.Compare();  // 1 comparison against the pivot
+      counter.Access();   // 1 memory access (read first[pos])
+      if (comp(proj(first[pos]), proj(pivot))) {
+         std::iter_swap(first + lt, first + pos);
+         counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+         ++lt;
+         ++pos;
+         continue;
+      }
+      counter.Compare();  // 1 comparison the other way round
+      if (comp(proj(pivot), proj(first[pos]))) {
+         std::iter_swap(first + pos, first + gt);
+         counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+         --gt;
+      }
+      else {
+         ++pos;
+      }
+   }
+}
+
+/* If either side of the split of first[i..k] into first[i..lowEnd] and
+ first[highStart..k] is under an eighth of the range, move the quarter points
+ of each side large enough to be partitioned again to its ends */
+template <class RandomIt, class Counter>
+void BreakPatterns(RandomIt first, int i, int lowEnd, int k, int highStart, int insertion_threshold,
+                   Counter& counter) {
+   int size = k - i + 1;
+   int lowSize = lowEnd - i + 1;
+   int highSize = k - highStart + 1;
+
+   if (lowSize >= size / 8 && highSize >= size / 8) {
+      return;
+   }
+   if (lowSize > insertion_threshold) {
+      std::iter_swap(first + i, first + (i + lowSize / 4));
+      std::iter_swap(first + lowEnd, first + (lowEnd - lowSize / 4));
+      counter.Access(8);  // Total for 2 swaps: 2 * 4 = 8 memory accesses
+   }
+   if (highSize > insertion_threshold) {
+      std::iter_swap(first + highStart, first + (highStart + highSize / 4));
+      std::iter_swap(first + k, first + (k - highSize / 4));
+      counter.Access(8);  // Total for 2 swaps: 2 * 4 = 8 memory accesses
+   }
+}
+
+/* QuickSortIntroLoop with PartitionBlock. When bounded_below, first[i - 1] is
+ no greater than anything in first[i..k], which holds for every range split
+ off to the right of a pivot. A pivot equal to it is then the smallest key in
+ the range, which only happens when keys repeat, so the range is split three
+ ways and every copy of the pivot is set aside at once (as pdqsort does). */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortBlockLoop(RandomIt first, int i, int k, int depth_limit, int insertion_threshold,
+                        bool bounded_below, Compare comp, Proj proj, Counter& counter) {
+   int lowEnd = 0;
+   int highStart = 0;
+
+   while (k - i + 1 > insertion_threshold) {
+      /* Too many bad splits, finish this partition in guaranteed O(n log n) */
+      if (depth_limit == 0) {
+         HeapSortRange(first, i, k, comp, proj, counter);
+         return;
+      }
+      --depth_limit;
+
+      // Both partitions take their pivot from the front
+      ChoosePivot(first, i, k, comp, proj, counter);
+      std::iter_swap(first + i, first + (i + (k - i) / 2));
+      counter.Access(4);  // Total for swap: 1 + 2 + 1 = 4 memory accesses
+
+      bool repeated = false;
+      if (bounded_below) {
+         counter.Compare();  // 1 comparison of the pivot against its predecessor
+         counter.Access(2);  // 2 memory accesses (read both)
+         repeated = !comp(proj(first[i - 1]), proj(first[i]));
+      }
+
+      if (repeated) {
+         PartitionThreeWay(first, i, k, comp, proj, counter, lowEnd, highStart);
+         --lowEnd;
+         ++highStart;
+      }
+      else {
+         lowEnd = PartitionBlock(first, i, k, comp, proj, counter);
+         highStart = lowEnd + 1;
+         --lowEnd;
+      }
+
+      /* A lopsided split usually means a pattern the pivot choice keeps
+       falling for, such as descending input. Swap a few elements of each
+       side out of place so the next pivots see different candidates. */
+      if (!repeated) {
+         BreakPatterns(first, i, lowEnd, k, highStart, insertion_threshold, counter);
+      }
+
+      /* Recurse into the smaller side and loop on the larger one */
+      if (lowEnd - i < k - highStart) {
+         QuickSortBlockLoop(first, i, lowEnd, depth_limit, insertion_threshold, bounded_below,
+                            comp, proj, counter);
+         i = highStart;
+         bounded_below = true;
+      }
+      else {
+         QuickSortBlockLoop(first, highStart, k, depth_limit, insertion_threshold, true,
+                            comp, proj, counter);
+         k = lowEnd;
+      }
+   }
+
+   InsertionSortRange(first, i, k, comp, proj, counter);
+}
+
+// Allow 2 * floor(log2(n)) levels before falling back to heapsort
+inline int QuickSortDepthLimit(int size) {
+   int depth_limit = 0;
+
+   for (int n = size; n > 1; n /= 2) {
+      depth_limit += 2;
+   }
+   return depth_limit;
+}
+
+/* Introsort. Median-of-three (ninther on large partitions) pivots, insertion
+ sort below insertion_threshold, a loop on the larger side instead of a second
+ recursive call, and heapsort once the depth passes 2 * log2(n). scheme picks
+ the Hoare partition or the branchless block partition. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortIntro(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                    int insertion_threshold = QUICKSORT_INSERTION_THRESHOLD,
+                    PartitionScheme scheme = PARTITION_HOARE) {
+   int size = last - first;
+
+   if (size < 2) {
+      return;
+   }
+
+   if (scheme == PARTITION_BLOCK) {
+      QuickSortBlockLoop(first, 0, size - 1, QuickSortDepthLimit(size), insertion_threshold, false,
+                         comp, proj, counter);
+   }
+   else {
+      QuickSortIntroLoop(first, 0, size - 1, QuickSortDepthLimit(size), insertion_threshold,
+                         comp, proj, counter);
+   }
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void QuickSortIntro(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   QuickSortIntro(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void QuickSortIntro(std::vector<int>* numbers, Counter& counter,
+                    int insertion_threshold = QUICKSORT_INSERTION_THRESHOLD,
+                    PartitionScheme scheme = PARTITION_HOARE) {
+   QuickSortIntro(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                  counter, insertion_threshold, scheme);
+}
+
+void QuickSortIntro(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                    int insertion_threshold = QUICKSORT_INSERTION_THRESHOLD,
+                    PartitionScheme scheme = PARTITION_HOARE);
+
+// QuickSortIntro() with the block partition
+template <class Counter>
+void QuickSortBlock(std::vector<int>* numbers, Counter& counter) {
+   QuickSortIntro(numbers, counter, QUICKSORT_INSERTION_THRESHOLD, PARTITION_BLOCK);
+}
+
+/* Partition first[i..k] until it is at most grain elements, forking the
+ smaller side of each split onto the pool */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortParallelTask(RandomIt first, int i, int k, int depth_limit, int grain,
+                           Compare comp, Proj proj, TaskGroup& group,
+                           ThreadCounters<Counter>& counters) {
+   Counter counter;
+   int j = 0;
+
+   while (k - i + 1 > grain && depth_limit > 0) {
+      --depth_limit;
+
+      ChoosePivot(first, i, k, comp, proj, counter);
+      j = Partition(first, i, k, comp, proj, counter);
+
+      if (j - i < k - j) {
+         int low = i;
+         int high = j;
+         group.Run([=, &group, &counters] {
+            QuickSortParallelTask(first, low, high, depth_limit, grain, comp, proj, group, counters);
+         });
+         i = j + 1;
+      }
+      else {
+         int low = j + 1;
+         int high = k;
+         group.Run([=, &group, &counters] {
+            QuickSortParallelTask(first, low, high, depth_limit, grain, comp, proj, group, counters);
+         });
+         k = j;
+      }
+   }
+
+   // Small enough (or recursed too deep), finish serially on this thread
+   QuickSortIntroLoop(first, i, k, depth_limit, QUICKSORT_INSERTION_THRESHOLD, comp, proj, counter);
+   counters.Add(counter);
+}
+
+/* Parallel introsort on a work-stealing pool of num_threads threads (0 for one
+ per hardware thread). After each partition the smaller side above grain is
+ forked as a task. Each task counts into its own Counter and the per-thread
+ totals are added to counter at the end, so Counter must be default
+ constructible. */
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortParallel(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       int num_threads = 0, int grain = QUICKSORT_PARALLEL_GRAIN) {
+   int size = last - first;
+
+   if (size <= grain || num_threads == 1) {
+      QuickSortIntro(first, last, comp, proj, counter);
+      return;
+   }
+
+   ThreadPool pool(num_threads);
+   QuickSortParallel(first, last, comp, proj, counter, pool, grain);
+}
+
+// QuickSortParallel on an existing pool
+template <class RandomIt, class Compare, class Proj, class Counter>
+void QuickSortParallel(RandomIt first, RandomIt last, Compare comp, Proj proj, Counter& counter,
+                       ThreadPool& pool, int grain = QUICKSORT_PARALLEL_GRAIN) {
+   int size = last - first;
+
+   if (size <= grain) {
+      QuickSortIntro(first, last, comp, proj, counter);
+      return;
+   }
+
+   ThreadCounters<Counter> counters(pool);
+   {
+      TaskGroup group(pool);
+      QuickSortParallelTask(first, 0, size - 1, QuickSortDepthLimit(size), grain, comp, proj, group, counters);
+      group.Wait();
+   }
+
+   counter.Add(counters.Total());
+}
+
+template <class RandomIt, class Compare = std::less<>, class Proj = Identity>
+void QuickSortParallel(RandomIt first, RandomIt last, Compare comp = Compare(), Proj proj = Proj()) {
+   NoCount counter;
+   QuickSortParallel(first, last, comp, proj, counter);
+}
+
+template <class Counter>
+void QuickSortParallel(std::vector<int>* numbers, Counter& counter,
+                       int num_threads = 0, int grain = QUICKSORT_PARALLEL_GRAIN) {
+   QuickSortParallel(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, num_threads, grain);
+}
+
+void QuickSortParallel(std::vector<int>* numbers, int& comp_count, int& mem_count,
+                       int num_threads = 0, int grain = QUICKSORT_PARALLEL_GRAIN);
+
+template <class Counter>
+void QuickSortParallel(std::vector<int>* numbers, Counter& counter, ThreadPool& pool,
+                       int grain = QUICKSORT_PARALLEL_GRAIN) {
+   QuickSortParallel(numbers->data(), numbers->data() + numbers->size(), std::less<int>(), Identity(),
+                     counter, pool, grain);
+}
+
+#endif
@@ -0,0 +1,20 @@
+// Radix Sort
+//
+// Byte-wise radix sorts for 32-bit int samples.
+
+#include "radixsort.h"
+
+void RadixSort(std::vector<int>* numbers, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   RadixSort(numbers, counter);
+}
+
+void RadixSortInPlace(std::vector<int>* numbers, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   RadixSortInPlace(numbers, counter);
+}
+
+void CountingSort(std::vector<int>* numbers, int low, int high, int& comp_count, int& mem_count) {
+   IntCounts counter(comp_count, mem_count);
+   CountingSort(numbers, low, high, counter);
+}
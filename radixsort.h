@@ -0,0 +1,215 @@
+// Radix Sort
+//
+// Byte-wise radix sorts for 32-bit int samples.
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <new>
+#include <vector>
+#include "counting.h"
+#include "insertionsort.h"
+
+// Buckets at or below this size are finished with insertion sort by the MSD sort
+const int RADIX_INSERTION_THRESHOLD = 32;
+
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+const int RADIX_PASSES = 32 / RADIX_BITS;
+
+/* Digit of value at the given shift, with the sign bit flipped so negative
+ numbers sort below positive ones */
+inline unsigned int RadixDigit(int value, int shift) {
+   return ((unsigned int)value ^ 0x80000000u) >> shift & (RADIX_BUCKETS - 1);
+}
+
+/* The sorts are templates on a counting policy (counting.h) with an int&
+ overload that keeps the original interface. Radix sorts compare nothing, so
+ only memory accesses are counted. */
+
+/* American flag sort of numbers[i..k] on the digit at shift and below */
+template <class Counter>
+void RadixSortInPlaceRecurse(int* numbers, int i, int k, int shift, Counter& counter) {
+   int count[RADIX_BUCKETS] = {};
+   int heads[RADIX_BUCKETS];
+   int tails[RADIX_BUCKETS];
+   int offset = i;
+
+   if (k - i + 1 <= RADIX_INSERTION_THRESHOLD) {
+      InsertionSortRange(numbers, i, k, counter);
+      return;
+   }
+
+   counter.SetPhase(PHASE_DISTRIBUTE);
+   for (int pos = i; pos <= k; ++pos) {
+      count[RadixDigit(numbers[pos], shift)]++;
+      counter.Access();  // 1 memory access (read numbers[pos])
+   }
+
+   for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+      heads[bucket] = offset;
+      offset += count[bucket];
+      tails[bucket] = offset;
+   }
+
+   /* Walk each bucket and send every misplaced element to the next free slot
+    of its own bucket, carrying the displaced element along (cycle leader) */
+   for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+      while (heads[bucket] < tails[bucket]) {
+         int value = numbers[heads[bucket]];
+         unsigned int digit = RadixDigit(value, shift);
+         counter.Access();  // 1 memory access (read element at the bucket head)
+
+         while (digit != (unsigned int)bucket) {
+            int displaced = numbers[heads[digit]];
+            numbers[heads[digit]++] = value;
+            counter.Access(2);  // 1 read + 1 write
+            value = displaced;
+            digit = RadixDigit(value, shift);
+         }
+
+         numbers[heads[bucket]++] = value;
+         counter.Access();  // 1 memory access (write element into its bucket)
+      }
+   }
+
+   if (shift == 0) {
+      return;  // Last digit, every bucket is now a run of equal values
+   }
+
+   offset = i;
+   for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+      if (count[bucket] > 1) {
+         RadixSortInPlaceRecurse(numbers, offset, offset + count[bucket] - 1, shift - RADIX_BITS, counter);
+      }
+      offset += count[bucket];
+   }
+}
+
+/* In-place MSD radix sort (American flag sort). Needs no scratch buffer,
+ only a fixed-size count table per level. */
+template <class Counter>
+void RadixSortInPlace(std::vector<int>* numbers, Counter& counter) {
+   int size = numbers->size();
+
+   if (size < 2) {
+      return;
+   }
+
+   RadixSortInPlaceRecurse(numbers->data(), 0, size - 1, 32 - RADIX_BITS, counter);
+}
+
+void RadixSortInPlace(std::vector<int>* numbers, int& comp_count, int& mem_count);
+
+/* LSD radix sort with 8-bit digits. One pass over the input builds the
+ histograms of all four digits, and passes where every element has the same
+ digit are skipped. Negative values are ordered by flipping the sign bit.
+ Falls back to RadixSortInPlace if the scratch buffer cannot be allocated. */
+template <class Counter>
+void RadixSort(std::vector<int>* numbers, Counter& counter) {
+   int size = numbers->size();
+   int counts[RADIX_PASSES][RADIX_BUCKETS] = {};
+   std::vector<int> scratch;
+   int* src = nullptr;
+   int* dst = nullptr;
+   int* temp = nullptr;
+
+   if (size < 2) {
+      return;
+   }
+
+   counter.SetPhase(PHASE_DISTRIBUTE);
+   try {
+      scratch.resize(size);
+   } catch (const std::bad_alloc&) {
+      // Not enough memory for a second copy, sort in place instead
+      RadixSortInPlace(numbers, counter);
+      return;
+   }
+
+   // Build the histograms of every digit in a single pass
+   counter.Pass();
+   for (int pos = 0; pos < size; ++pos) {
+      int value = (*numbers)[pos];
+      counter.Access();  // 1 memory access (read numbers[pos])
+      for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+         counts[pass][RadixDigit(value, pass * RADIX_BITS)]++;
+      }
+   }
+
+   src = numbers->data();
+   dst = scratch.data();
+
+   for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+      int shift = pass * RADIX_BITS;
+      int* count = counts[pass];
+      int offset = 0;
+
+      // Every element has the same digit, this pass would not move anything
+      if (count[RadixDigit(src[0], shift)] == size) {
+         continue;
+      }
+
+      // Turn the counts into starting offsets
+      for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+         int bucketSize = count[bucket];
+         count[bucket] = offset;
+         offset += bucketSize;
+      }
+
+      // Scatter in input order, which keeps each pass stable
+      for (int pos = 0; pos < size; ++pos) {
+         int value = src[pos];
+         dst[count[RadixDigit(value, shift)]++] = value;
+         counter.Access(2);  // 1 read + 1 write
+      }
+      counter.Pass();
+
+      temp = src;
+      src = dst;
+      dst = temp;
+   }
+
+   // An odd number of scatter passes leaves the result in the scratch buffer
+   if (src != numbers->data()) {
+      for (int pos = 0; pos < size; ++pos) {
+         (*numbers)[pos] = src[pos];
+         counter.Access(2);  // 1 read + 1 write
+      }
+      counter.Pass();
+   }
+}
+
+void RadixSort(std::vector<int>* numbers, int& comp_count, int& mem_count);
+
+/* Counting sort for samples whose values all lie in [low, high]. One pass
+ counts each value, a second writes the values back in order, so it beats
+ the radix passes when the range is not much larger than the sample. */
+template <class Counter>
+void CountingSort(std::vector<int>* numbers, int low, int high, Counter& counter) {
+   int size = numbers->size();
+   std::vector<int> count((size_t)((long long)high - low + 1));
+   int pos = 0;
+
+   if (size < 2) {
+      return;
+   }
+
+   counter.SetPhase(PHASE_DISTRIBUTE);
+   for (int value : *numbers) {
+      count[(long long)value - low]++;
+      counter.Access();  // 1 memory access (read numbers[pos])
+   }
+
+   for (size_t bucket = 0; bucket < count.size(); ++bucket) {
+      int value = (int)(low + (long long)bucket);
+      for (int n = count[bucket]; n > 0; --n) {
+         (*numbers)[pos++] = value;
+         counter.Access();  // 1 memory access (write value)
+      }
+   }
+}
+
+void CountingSort(std::vector<int>* numbers, int low, int high, int& comp_count, int& mem_count);
+
+#endif
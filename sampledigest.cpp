@@ -0,0 +1,127 @@
+// Sample Digest
+//
+// Digest sidecar of a sample file, see sampledigest.h.
+
+#include "sampledigest.h"
+#include <cstdio>
+#include <stdexcept>
+#include "json.hpp"
+
+#include <sys/stat.h>
+
+using json = nlohmann::json;
+
+/* Size and modification time of filename, false if it cannot be read */
+static bool FileStamp(const std::string& filename, uint64_t& size, uint64_t& modified) {
+   struct stat info;
+
+   if (stat(filename.c_str(), &info) != 0) {
+      return false;
+   }
+   size = info.st_size;
+   modified = (uint64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+   return true;
+}
+
+std::string DigestSidecar(const std::string& filename) {
+   return filename + ".digest";
+}
+
+bool DigestIndex::Open(const std::string& filename) {
+   std::string sidecar = DigestSidecar(filename);
+   std::ifstream file(sidecar);
+   uint64_t size = 0;
+   uint64_t modified = 0;
+   json data;
+
+   entries_.clear();
+   if (!file.is_open() || !FileStamp(filename, size, modified)) {
+      return false;
+   }
+   try {
+      file >> data;
+   } catch (const json::parse_error&) {
+      throw std::runtime_error("Invalid JSON in file: " + sidecar);
+   }
+   if (!data.contains("samples") || !data["samples"].is_object()) {
+      throw std::runtime_error("Invalid JSON in file: " + sidecar);
+   }
+
+   // The sample file was rewritten after the sidecar
+   if (data.value("fileSize", (uint64_t)0) != size || data.value("modified", (uint64_t)0) != modified) {
+      return false;
+   }
+
+   for (auto& sample : data["samples"].items()) {
+      const json& value = sample.value();
+      DigestEntry entry;
+      if (!value.is_object() || !value.contains("length") || !DigestFromHex(value.value("digest", ""), entry.digest)) {
+         throw std::runtime_error("Invalid JSON in file: " + sidecar);
+      }
+      entry.length = value["length"].get<size_t>();
+      entries_[sample.key()] = entry;
+   }
+   return true;
+}
+
+const DigestEntry* DigestIndex::Find(const std::string& name) const {
+   auto entry = entries_.find(name);
+   return entry != entries_.end() ? &entry->second : nullptr;
+}
+
+DigestWriter::DigestWriter() {
+}
+
+DigestWriter::~DigestWriter() {
+   // Not closed, most likely because of an error: no sidecar rather than a partial one
+   if (json_) {
+      json_.reset();
+      output_.close();
+      std::remove((DigestSidecar(filename_) + ".tmp").c_str());
+   }
+}
+
+void DigestWriter::Open(const std::string& filename) {
+   std::string sidecar = DigestSidecar(filename);
+
+   filename_ = filename;
+   output_.open(sidecar + ".tmp", std::ios::trunc);
+   if (!output_.is_open()) {
+      throw std::runtime_error("Cannot write file: " + sidecar);
+   }
+   json_.reset(new JsonWriter(output_));
+   json_->BeginObject();
+   json_->Key("samples");
+   json_->BeginObject();
+}
+
+void DigestWriter::Add(const std::string& name, const int* data, size_t size) {
+   json_->Key(name);
+   json_->BeginObject();
+   json_->Key("digest");
+   json_->String(DigestToHex(SampleDigest(data, size)));
+   json_->Key("length");
+   json_->UInt(size);
+   json_->EndObject();
+}
+
+void DigestWriter::Close() {
+   std::string sidecar = DigestSidecar(filename_);
+   uint64_t size = 0;
+   uint64_t modified = 0;
+
+   if (!FileStamp(filename_, size, modified)) {
+      throw std::runtime_error("Cannot open file: " + filename_);
+   }
+   json_->EndObject();
+   json_->Key("fileSize");
+   json_->UInt(size);
+   json_->Key("modified");
+   json_->UInt(modified);
+   json_->EndObject();   // Flushes the sidecar
+   json_.reset();
+   output_.close();
+   if (!output_ || std::rename((sidecar + ".tmp").c_str(), sidecar.c_str()) != 0) {
+      throw std::runtime_error("Cannot write file: " + sidecar);
+   }
+}
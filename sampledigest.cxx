@@ -0,0 +1,44 @@
+#include <iostream>       // for input/output streams (cout, cerr)
+#include <string>         // for using string
+#include "samplereader.h" // include the streaming sample reader
+#include "sampledigest.h" // include the digest sidecar writer
+
+using namespace std;          // use standard namespace
+
+int main(int argc, char** argv) {
+    // check if correct number of command line arguments provided
+    // argc should be at least 2: program name + one or more sample filenames
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <samples> [<samples> ...]" << endl; // print error message to standard error
+        cerr << "       writes <samples>.digest next to each JSON or binary sample file" << endl;
+        return 1;  // return error code 1 indicating failure
+    }
+
+    for (int arg = 1; arg < argc; arg++) {
+        string filename = argv[arg];  // sample file to digest
+        try {
+            // samples are read one at a time, binary files straight from the mapping
+            SampleReader reader;
+            reader.Open(filename);
+            DigestWriter digests;
+            digests.Open(filename);
+
+            string sample_name;          // name of the current sample
+            const int* data = nullptr;   // values of the current sample
+            size_t size = 0;             // number of values in the current sample
+            size_t samples = 0;          // samples digested so far
+            while (reader.Next(sample_name, data, size)) {
+                digests.Add(sample_name, data, size);
+                samples++;
+            }
+            digests.Close();  // records the size and time of the finished sample file
+
+            cout << filename << ": " << samples << " samples" << endl;  // progress, one line per file
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl; // print error message if reading or writing fails
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+
+    return 0;  // Return 0 :)
+}
@@ -0,0 +1,71 @@
+// Sample Digest
+//
+// Digest sidecar of a sample file: the length and 128-bit digest of every
+// sample, so two result files can be compared without reading the samples
+// they have in common.
+
+#ifndef SAMPLEDIGEST_H
+#define SAMPLEDIGEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include "checksum.h"
+#include "jsonwriter.h"
+
+struct DigestEntry {
+   size_t length = 0;
+   Digest digest;
+};
+
+// Name of the digest sidecar of a sample file
+std::string DigestSidecar(const std::string& filename);
+
+/* The digests of a sample file, read from its sidecar <file>.digest:
+
+   {"samples": {"<name>": {"digest": "<hex>", "length": N}, ...}, "fileSize": N, "modified": NS}
+
+ fileSize and modified are the size of the sample file and its modification
+ time in nanoseconds when the sidecar was written. A sidecar that no longer
+ matches its file is stale and is not loaded. Errors throw runtime_error. */
+class DigestIndex {
+public:
+   // Load the sidecar of filename, false if it has none or it is stale
+   bool Open(const std::string& filename);
+
+   // Entry for the sample called name, null if the file has none
+   const DigestEntry* Find(const std::string& name) const;
+
+   const std::map<std::string, DigestEntry>& Entries() const { return entries_; }
+
+private:
+   std::map<std::string, DigestEntry> entries_;
+};
+
+/* Writes the sidecar of a sample file while its samples go by, so memory
+ stays bounded however many samples there are. Close() has to come after the
+ sample file is complete, as it records the file's size and modification
+ time. The sidecar is written under a temporary name and renamed in Close().
+ Errors throw runtime_error. */
+class DigestWriter {
+public:
+   DigestWriter();
+   ~DigestWriter();
+
+   // Start the sidecar of the sample file filename
+   void Open(const std::string& filename);
+
+   void Add(const std::string& name, const int* data, size_t size);
+
+   void Close();
+
+private:
+   std::string filename_;
+   std::ofstream output_;
+   std::unique_ptr<JsonWriter> json_;
+};
+
+#endif
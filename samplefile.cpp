@@ -0,0 +1,192 @@
+// Sample File
+//
+// Compact binary container for samples. Payloads are stored as aligned
+// native int32 arrays so a mapped file can be used in place.
+
+#include "samplefile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(SampleFileHeader) == 64, "SampleFileHeader must stay 64 bytes");
+static_assert(sizeof(int) == sizeof(int32_t), "payloads are stored as int32");
+
+bool IsBinarySampleFile(const std::string& filename) {
+   std::ifstream input(filename, std::ios::binary);
+   char magic[sizeof(SAMPLE_FILE_MAGIC)];
+
+   if (!input.read(magic, sizeof(magic))) {
+      return false;
+   }
+   return memcmp(magic, SAMPLE_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+SampleFileWriter::SampleFileWriter() : offset_(0) {
+   memset(&header_, 0, sizeof(header_));
+}
+
+SampleFileWriter::~SampleFileWriter() {
+   if (output_.is_open()) {
+      try {
+         Close();
+      } catch (const std::exception&) {
+         // Nothing to report to from a destructor
+      }
+   }
+}
+
+void SampleFileWriter::Open(const std::string& filename, int arraySize, int numSamples) {
+   filename_ = filename;
+   output_.open(filename, std::ios::binary | std::ios::trunc);
+   if (!output_.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+
+   memset(&header_, 0, sizeof(header_));
+   memcpy(header_.magic, SAMPLE_FILE_MAGIC, sizeof(header_.magic));
+   header_.version = 1;
+   header_.arraySize = arraySize;
+   header_.numSamples = numSamples;
+   names_.clear();
+   entries_.clear();
+
+   // Placeholder header, rewritten by Close() once the offsets are known
+   output_.write((const char*)&header_, sizeof(header_));
+   offset_ = sizeof(header_);
+}
+
+void SampleFileWriter::SetMetadata(int arraySize, int numSamples) {
+   header_.arraySize = arraySize;
+   header_.numSamples = numSamples;
+}
+
+void SampleFileWriter::Add(const std::string& name, const int* data, size_t size) {
+   static const char padding[SAMPLE_FILE_ALIGNMENT] = {};
+   SampleFileEntry entry;
+   size_t pad = (SAMPLE_FILE_ALIGNMENT - offset_ % SAMPLE_FILE_ALIGNMENT) % SAMPLE_FILE_ALIGNMENT;
+
+   output_.write(padding, pad);
+   offset_ += pad;
+
+   entry.payloadOffset = offset_;
+   entry.length = size;
+   entry.nameOffset = names_.size();
+   entry.nameLength = name.size();
+   entries_.push_back(entry);
+   names_ += name;
+
+   output_.write((const char*)data, size * sizeof(int32_t));
+   offset_ += size * sizeof(int32_t);
+
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
+
+void SampleFileWriter::Close() {
+   header_.sampleCount = entries_.size();
+   header_.nameTableOffset = offset_;
+   output_.write(names_.data(), names_.size());
+   offset_ += names_.size();
+
+   // Keep the index entries aligned inside the mapping
+   while (offset_ % alignof(SampleFileEntry) != 0) {
+      output_.put('\0');
+      ++offset_;
+   }
+
+   header_.indexOffset = offset_;
+   output_.write((const char*)entries_.data(), entries_.size() * sizeof(SampleFileEntry));
+
+   output_.seekp(0);
+   output_.write((const char*)&header_, sizeof(header_));
+   output_.close();
+
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
+
+MappedSampleFile::MappedSampleFile()
+   : base_(nullptr), length_(0), header_(nullptr), entries_(nullptr) {
+}
+
+MappedSampleFile::~MappedSampleFile() {
+   Close();
+}
+
+void MappedSampleFile::Open(const std::string& filename) {
+   struct stat info;
+   void* mapping = nullptr;
+   int fd = 0;
+
+   Close();
+   filename_ = filename;
+
+   fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+   if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SampleFileHeader)) {
+      close(fd);
+      throw std::runtime_error("Invalid sample file: " + filename);
+   }
+
+   length_ = info.st_size;
+   mapping = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);  // The mapping keeps the file open
+   if (mapping == MAP_FAILED) {
+      length_ = 0;
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+
+   base_ = (const char*)mapping;
+   madvise(mapping, length_, MADV_SEQUENTIAL);  // Samples are usually read front to back
+
+   header_ = (const SampleFileHeader*)base_;
+   entries_ = (const SampleFileEntry*)(base_ + header_->indexOffset);
+
+   // Check every offset so a truncated file cannot make Data() read past the mapping
+   bool valid = memcmp(header_->magic, SAMPLE_FILE_MAGIC, sizeof(header_->magic)) == 0
+                && header_->version == 1
+                && header_->indexOffset <= length_
+                && header_->indexOffset % alignof(SampleFileEntry) == 0
+                && (length_ - header_->indexOffset) / sizeof(SampleFileEntry) >= header_->sampleCount
+                && header_->nameTableOffset <= header_->indexOffset;
+   for (size_t index = 0; valid && index < header_->sampleCount; ++index) {
+      const SampleFileEntry& entry = entries_[index];
+      valid = entry.payloadOffset % sizeof(int32_t) == 0
+              && entry.payloadOffset <= header_->nameTableOffset
+              && entry.length <= (header_->nameTableOffset - entry.payloadOffset) / sizeof(int32_t)
+              && entry.nameOffset <= header_->indexOffset - header_->nameTableOffset
+              && entry.nameLength <= header_->indexOffset - header_->nameTableOffset - entry.nameOffset;
+   }
+   if (!valid) {
+      Close();
+      throw std::runtime_error("Invalid sample file: " + filename);
+   }
+}
+
+void MappedSampleFile::Close() {
+   if (base_ != nullptr) {
+      munmap((void*)base_, length_);
+   }
+   base_ = nullptr;
+   length_ = 0;
+   header_ = nullptr;
+   entries_ = nullptr;
+}
+
+std::string MappedSampleFile::Name(size_t index) const {
+   const SampleFileEntry& entry = entries_[index];
+   return std::string(base_ + header_->nameTableOffset + entry.nameOffset, entry.nameLength);
+}
+
+const int* MappedSampleFile::Data(size_t index) const {
+   return (const int*)(base_ + entries_[index].payloadOffset);
+}
@@ -0,0 +1,104 @@
+// Sample File
+//
+// Compact binary container for samples. Payloads are stored as aligned
+// native int32 arrays so a mapped file can be used in place.
+
+#ifndef SAMPLEFILE_H
+#define SAMPLEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* File layout (all integers native-endian):
+
+   SampleFileHeader                                  64 bytes
+   payload of each sample, int32[length]             each starts on a
+                                                     SAMPLE_FILE_ALIGNMENT boundary
+   name table, the sample names back to back
+   SampleFileEntry[sampleCount]                      at indexOffset
+
+ The index goes last so the writer can stream samples without knowing how many
+ there are. */
+
+const char SAMPLE_FILE_MAGIC[8] = {'S', 'M', 'P', 'L', 'B', 'I', 'N', '1'};
+const size_t SAMPLE_FILE_ALIGNMENT = 64;
+
+struct SampleFileHeader {
+   char magic[8];
+   uint32_t version;
+   int32_t arraySize;      // metadata.arraySize
+   int32_t numSamples;     // metadata.numSamples
+   uint32_t sampleCount;   // Number of entries in the index
+   uint64_t nameTableOffset;
+   uint64_t indexOffset;
+   uint8_t reserved[24];
+};
+
+struct SampleFileEntry {
+   uint64_t payloadOffset;  // Byte offset of the int32 payload
+   uint64_t length;         // Number of int32 values
+   uint64_t nameOffset;     // Byte offset of the name within the name table
+   uint64_t nameLength;
+};
+
+// True if filename starts with SAMPLE_FILE_MAGIC
+bool IsBinarySampleFile(const std::string& filename);
+
+/* Writes a sample file one sample at a time. Errors throw runtime_error. */
+class SampleFileWriter {
+public:
+   SampleFileWriter();
+   ~SampleFileWriter();
+
+   void Open(const std::string& filename, int arraySize = 0, int numSamples = 0);
+
+   // Header metadata can be set any time before Close()
+   void SetMetadata(int arraySize, int numSamples);
+
+   void Add(const std::string& name, const int* data, size_t size);
+
+   // Write the name table and index, then patch the header
+   void Close();
+
+private:
+   std::string filename_;
+   std::ofstream output_;
+   SampleFileHeader header_;
+   std::string names_;
+   std::vector<SampleFileEntry> entries_;
+   uint64_t offset_;
+};
+
+/* Read-only memory mapping of a sample file. Data() points straight into the
+ mapping, so samples are never copied or parsed. Errors throw runtime_error. */
+class MappedSampleFile {
+public:
+   MappedSampleFile();
+   ~MappedSampleFile();
+
+   MappedSampleFile(const MappedSampleFile&) = delete;
+   MappedSampleFile& operator=(const MappedSampleFile&) = delete;
+
+   void Open(const std::string& filename);
+   void Close();
+
+   int ArraySize() const { return header_->arraySize; }
+   int NumSamples() const { return header_->numSamples; }
+   size_t SampleCount() const { return header_->sampleCount; }
+
+   std::string Name(size_t index) const;
+   const int* Data(size_t index) const;
+   size_t Size(size_t index) const { return entries_[index].length; }
+
+private:
+   std::string filename_;
+   const char* base_;
+   size_t length_;
+   const SampleFileHeader* header_;
+   const SampleFileEntry* entries_;
+};
+
+#endif
@@ -0,0 +1,395 @@
+// Sample Reader
+//
+// Streams samples out of a sample file one at a time instead of parsing the
+// whole document, so memory stays bounded by the largest single sample.
+
+#include "samplereader.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// Size of each read from the file
+const size_t SAMPLE_READER_BUFFER_SIZE = 1 << 20;
+
+SampleReader::SampleReader()
+   : buffer_(SAMPLE_READER_BUFFER_SIZE), pos_(0), len_(0), started_(false), finished_(true),
+     pending_(false), binary_(false), nextIndex_(0) {
+}
+
+void SampleReader::Open(const std::string& filename) {
+   filename_ = filename;
+
+   binary_ = IsBinarySampleFile(filename);
+   if (binary_) {
+      mapped_.Open(filename);
+      nextIndex_ = 0;
+      finished_ = false;
+      pending_ = false;
+      metadata_ = nlohmann::json();
+      metadata_["arraySize"] = mapped_.ArraySize();
+      metadata_["numSamples"] = mapped_.NumSamples();
+      return;
+   }
+
+   input_.open(filename, std::ios::binary);
+   if (!input_.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+
+   pos_ = 0;
+   len_ = 0;
+   started_ = false;
+   finished_ = false;
+   pending_ = false;
+   metadata_ = nlohmann::json();
+}
+
+void SampleReader::Fail() const {
+   throw std::runtime_error("Invalid JSON in file: " + filename_);
+}
+
+bool SampleReader::Fill() {
+   input_.read(buffer_.data(), buffer_.size());
+   len_ = input_.gcount();
+   pos_ = 0;
+   return len_ > 0;
+}
+
+// Next character without consuming it, or EOF at the end of the file
+int SampleReader::Peek() {
+   if (pos_ == len_ && !Fill()) {
+      return EOF;
+   }
+   return (unsigned char)buffer_[pos_];
+}
+
+int SampleReader::Get() {
+   int c = Peek();
+   if (c != EOF) {
+      ++pos_;
+   }
+   return c;
+}
+
+void SampleReader::Expect(char expected) {
+   SkipWhitespace();
+   if (Get() != expected) {
+      Fail();
+   }
+}
+
+void SampleReader::SkipWhitespace() {
+   int c = Peek();
+   while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+      ++pos_;
+      c = Peek();
+   }
+}
+
+/* Read a JSON string (opening quote next in the input), decoding escapes */
+void SampleReader::ReadString(std::string& text) {
+   int c = 0;
+   unsigned int code = 0;
+
+   Expect('"');
+   text.clear();
+
+   while ((c = Get()) != '"') {
+      if (c == EOF) {
+         Fail();
+      }
+      if (c != '\\') {
+         text.push_back((char)c);
+         continue;
+      }
+
+      switch (c = Get()) {
+         case '"': case '\\': case '/': text.push_back((char)c); break;
+         case 'b': text.push_back('\b'); break;
+         case 'f': text.push_back('\f'); break;
+         case 'n': text.push_back('\n'); break;
+         case 'r': text.push_back('\r'); break;
+         case 't': text.push_back('\t'); break;
+         case 'u':
+            code = 0;
+            for (int digit = 0; digit < 4; ++digit) {
+               c = Get();
+               code <<= 4;
+               if (c >= '0' && c <= '9') code |= c - '0';
+               else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+               else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+               else Fail();
+            }
+            // Encode the code unit as UTF-8 (sample names are plain ASCII in practice)
+            if (code < 0x80) {
+               text.push_back((char)code);
+            }
+            else if (code < 0x800) {
+               text.push_back((char)(0xC0 | code >> 6));
+               text.push_back((char)(0x80 | (code & 0x3F)));
+            }
+            else {
+               text.push_back((char)(0xE0 | code >> 12));
+               text.push_back((char)(0x80 | (code >> 6 & 0x3F)));
+               text.push_back((char)(0x80 | (code & 0x3F)));
+            }
+            break;
+         default:
+            Fail();
+      }
+   }
+}
+
+/* Read a JSON array of integers (opening bracket next in the input) */
+void SampleReader::ReadIntArray(std::vector<int>& values) {
+   int c = 0;
+   bool negative = false;
+   long long value = 0;
+   int digits = 0;
+
+   Expect('[');
+   values.clear();
+
+   SkipWhitespace();
+   if (Peek() == ']') {
+      ++pos_;
+      return;
+   }
+
+   while (true) {
+      SkipWhitespace();
+
+      negative = false;
+      if (Peek() == '-') {
+         negative = true;
+         ++pos_;
+      }
+
+      value = 0;
+      digits = 0;
+      while ((c = Peek()) >= '0' && c <= '9') {
+         value = value * 10 + (c - '0');
+         ++pos_;
+         if (++digits > 10) {
+            Fail();  // Too long to be a 32-bit int
+         }
+      }
+      if (digits == 0) {
+         Fail();
+      }
+      if (negative) {
+         value = -value;
+      }
+      if (value < INT_MIN || value > INT_MAX) {
+         Fail();
+      }
+      values.push_back((int)value);
+
+      SkipWhitespace();
+      c = Get();
+      if (c == ']') {
+         return;
+      }
+      if (c != ',') {
+         Fail();
+      }
+   }
+}
+
+/* Copy the text of any JSON value (object, array, string or literal) */
+void SampleReader::ReadRawValue(std::string& text) {
+   int depth = 0;
+   bool in_string = false;
+   int c = 0;
+
+   SkipWhitespace();
+   text.clear();
+
+   while ((c = Peek()) != EOF) {
+      if (in_string) {
+         text.push_back((char)c);
+         ++pos_;
+         if (c == '\\') {
+            if ((c = Get()) == EOF) {
+               Fail();
+            }
+            text.push_back((char)c);
+         }
+         else if (c == '"') {
+            in_string = false;
+         }
+         continue;
+      }
+
+      if (depth == 0 && (c == ',' || c == '}')) {
+         return;  // End of a top-level value, leave the delimiter in the input
+      }
+
+      text.push_back((char)c);
+      ++pos_;
+      if (c == '"') {
+         in_string = true;
+      }
+      else if (c == '{' || c == '[') {
+         ++depth;
+      }
+      else if (c == '}' || c == ']') {
+         --depth;
+      }
+   }
+
+   Fail();
+}
+
+bool SampleReader::Next(std::string& name, const int*& data, size_t& size) {
+   if (!NextName(name)) {
+      return false;
+   }
+   pending_ = false;
+
+   if (binary_) {
+      data = mapped_.Data(nextIndex_);
+      size = mapped_.Size(nextIndex_);
+      ++nextIndex_;
+      return true;
+   }
+
+   ReadIntArray(sample_);
+   data = sample_.data();
+   size = sample_.size();
+   return true;
+}
+
+bool SampleReader::Next(std::string& name, Sample& sample) {
+   if (!NextName(name)) {
+      return false;
+   }
+   ReadValues(sample);
+   return true;
+}
+
+bool SampleReader::Next(std::string& name, std::vector<int>& sample) {
+   if (!NextName(name)) {
+      return false;
+   }
+   pending_ = false;
+
+   if (binary_) {
+      const int* data = mapped_.Data(nextIndex_);
+      sample.assign(data, data + mapped_.Size(nextIndex_));
+      ++nextIndex_;
+      return true;
+   }
+
+   ReadIntArray(sample);
+   return true;
+}
+
+bool SampleReader::NextName(std::string& name) {
+   std::string text;
+   int c = 0;
+
+   if (pending_) {
+      Skip();  // The values of the last sample were never asked for
+   }
+
+   if (binary_) {
+      if (nextIndex_ >= mapped_.SampleCount()) {
+         finished_ = true;
+         return false;
+      }
+      name = mapped_.Name(nextIndex_);
+      pending_ = true;
+      return true;
+   }
+
+   while (!finished_) {
+      SkipWhitespace();
+
+      if (!started_) {
+         Expect('{');
+         started_ = true;
+         SkipWhitespace();
+         if (Peek() == '}') {
+            ++pos_;
+            finished_ = true;
+            break;
+         }
+      }
+      else {
+         // Separator after the previous member
+         c = Get();
+         if (c == '}') {
+            finished_ = true;
+            break;
+         }
+         if (c != ',') {
+            Fail();
+         }
+      }
+
+      ReadString(name);
+      Expect(':');
+      SkipWhitespace();
+
+      if (name == "metadata") {
+         ReadRawValue(text);
+         try {
+            metadata_ = nlohmann::json::parse(text);
+         } catch (const std::exception&) {
+            Fail();
+         }
+         continue;
+      }
+
+      if (Peek() != '[') {
+         Fail();  // Every other member must be a sample array
+      }
+      pending_ = true;
+      return true;
+   }
+
+   return false;
+}
+
+void SampleReader::ReadValues(Sample& sample) {
+   pending_ = false;
+
+   if (binary_) {
+      sample.owned.clear();
+      sample.data = mapped_.Data(nextIndex_);
+      sample.size = mapped_.Size(nextIndex_);
+      ++nextIndex_;
+      return;
+   }
+
+   ReadIntArray(sample.owned);
+   sample.data = sample.owned.data();
+   sample.size = sample.owned.size();
+}
+
+void SampleReader::Skip() {
+   pending_ = false;
+
+   if (binary_) {
+      ++nextIndex_;
+      return;
+   }
+
+   // A sample array holds nothing but numbers, so its first ']' closes it
+   Expect('[');
+   while (true) {
+      if (pos_ == len_ && !Fill()) {
+         Fail();
+      }
+      const char* start = &buffer_[pos_];
+      const char* close = (const char*)memchr(start, ']', len_ - pos_);
+      if (close != nullptr) {
+         pos_ += close - start + 1;
+         return;
+      }
+      pos_ = len_;
+   }
+}
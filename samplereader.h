@@ -0,0 +1,95 @@
+// Sample Reader
+//
+// Streams samples out of a sample file one at a time instead of parsing the
+// whole document, so memory stays bounded by the largest single sample.
+
+#ifndef SAMPLEREADER_H
+#define SAMPLEREADER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "samplefile.h"
+
+/* A sample handed out by SampleReader::Next(). For a mapped binary file data
+ points into the mapping; for JSON the values are parsed into owned. Moving a
+ Sample keeps data valid, so samples can be queued for other threads. */
+struct Sample {
+   std::vector<int> owned;
+   const int* data = nullptr;
+   size_t size = 0;
+};
+
+/* Reads the {"metadata": {...}, "<name>": [ints], ...} layout. Sample arrays
+ are parsed straight into a vector<int>; only the metadata object goes through
+ the JSON library. Binary sample files (see samplefile.h) are recognized by
+ their magic number and mapped instead of parsed, in which case Metadata()
+ holds just arraySize and numSamples. Samples come back in file order.
+ Errors are reported by throwing runtime_error with a "Cannot open file" or
+ "Invalid JSON in file" message. */
+class SampleReader {
+public:
+   SampleReader();
+
+   // Open a sample file, throws runtime_error if it cannot be opened
+   void Open(const std::string& filename);
+
+   // Read the next sample, returns false once the file is exhausted
+   bool Next(std::string& name, std::vector<int>& sample);
+
+   /* Read the next sample without copying it out. data stays valid until the
+    next call, or for a binary file until the reader is closed. */
+   bool Next(std::string& name, const int*& data, size_t& size);
+
+   /* Read the next sample into a Sample that stays valid after later calls,
+    without copying binary samples out of the mapping */
+   bool Next(std::string& name, Sample& sample);
+
+   /* Read just the name of the next sample, returns false once the file is
+    exhausted. Its values are then taken by ReadValues() or passed over by
+    Skip(); a Next() or NextName() without either skips them. */
+   bool NextName(std::string& name);
+   void ReadValues(Sample& sample);
+
+   /* Pass over the values of the sample NextName() stopped at. A JSON array
+    is scanned for its closing bracket without parsing the integers, a binary
+    sample is not touched at all. */
+   void Skip();
+
+   // True if the open file is a mapped binary sample file
+   bool IsBinary() const { return binary_; }
+
+   // The metadata object, only guaranteed complete after Next() returns false
+   const nlohmann::json& Metadata() const { return metadata_; }
+
+   const std::string& Filename() const { return filename_; }
+
+private:
+   bool Fill();
+   int Peek();
+   int Get();
+   void Expect(char expected);
+   void SkipWhitespace();
+   void ReadString(std::string& text);
+   void ReadIntArray(std::vector<int>& values);
+   void ReadRawValue(std::string& text);
+   [[noreturn]] void Fail() const;
+
+   std::string filename_;
+   std::ifstream input_;
+   std::vector<char> buffer_;
+   size_t pos_;
+   size_t len_;
+   bool started_;
+   bool finished_;
+   nlohmann::json metadata_;
+   std::vector<int> sample_;  // Parsed JSON sample handed out by the zero-copy Next()
+   bool pending_;             // NextName() stopped in front of a sample's values
+
+   bool binary_;
+   MappedSampleFile mapped_;
+   size_t nextIndex_;
+};
+
+#endif
@@ -0,0 +1,144 @@
+// Selector
+//
+// Adaptive Sort(): profiles a sample of the input and runs the sort that is
+// expected to win on it.
+
+#include "selector.h"
+
+#include <fstream>
+#include <stdexcept>
+#include "json.hpp"
+#include "verify.h"
+
+using json = nlohmann::json;
+
+SortThresholds LoadSortThresholds(const std::string& filename) {
+   SortThresholds thresholds;
+   std::ifstream file(filename);
+   json data;
+
+   if (!file.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+   try {
+      file >> data;
+   } catch (const json::parse_error&) {
+      throw std::runtime_error("Invalid JSON in file: " + filename);
+   }
+
+   thresholds.insertionMaxSize = data.value("insertionMaxSize", thresholds.insertionMaxSize);
+   thresholds.presortedMaxRatio = data.value("presortedMaxRatio", thresholds.presortedMaxRatio);
+   thresholds.countingMaxRange = data.value("countingMaxRange", thresholds.countingMaxRange);
+   thresholds.radixMinSize = data.value("radixMinSize", thresholds.radixMinSize);
+   return thresholds;
+}
+
+void SaveSortThresholds(const std::string& filename, const SortThresholds& thresholds) {
+   std::ofstream file(filename);
+   json data;
+
+   if (!file.is_open()) {
+      throw std::runtime_error("Cannot write file: " + filename);
+   }
+
+   data["insertionMaxSize"] = thresholds.insertionMaxSize;
+   data["presortedMaxRatio"] = thresholds.presortedMaxRatio;
+   data["countingMaxRange"] = thresholds.countingMaxRange;
+   data["radixMinSize"] = thresholds.radixMinSize;
+   file << data.dump(4) << std::endl;
+}
+
+/* Add data[0..count-1] to the profile */
+static void ProfileBlock(const int* data, int count, InputProfile& profile) {
+   profile.inversions += FindInversions(data, count, 0, nullptr);
+   profile.pairs += count - 1;
+   profile.sampled += count;
+
+   for (int pos = 0; pos < count; ++pos) {
+      if (data[pos] < profile.min) {
+         profile.min = data[pos];
+      }
+      if (data[pos] > profile.max) {
+         profile.max = data[pos];
+      }
+   }
+}
+
+InputProfile ProfileInput(const int* data, int size) {
+   InputProfile profile;
+   long long stride = 0;
+
+   profile.size = size;
+   if (size == 0) {
+      return profile;
+   }
+   profile.min = data[0];
+   profile.max = data[0];
+
+   if (size <= PROFILE_FULL_SCAN) {
+      ProfileBlock(data, size, profile);
+      profile.exact = true;
+   }
+   else {
+      // Evenly spaced blocks, the first at the start and the last at the end
+      stride = (size - PROFILE_BLOCK_SIZE) / (PROFILE_BLOCKS - 1);
+      for (int block = 0; block < PROFILE_BLOCKS; ++block) {
+         ProfileBlock(data + block * stride, PROFILE_BLOCK_SIZE, profile);
+      }
+   }
+
+   // Every inversion starts a new ascending run
+   profile.runs = 1 + (long long)(profile.InversionRatio() * (size - 1) + 0.5);
+   return profile;
+}
+
+SortChoice ChooseSort(const int* data, const InputProfile& profile, const SortThresholds& thresholds,
+                      int& low, int& high) {
+   int size = profile.size;
+
+   if (size < 2) {
+      return SORT_NONE;
+   }
+
+   // Sorted as far as the profile saw, confirm on the whole input before skipping the sort
+   if (profile.inversions == 0 && (profile.exact || FindInversions(data, size, 1, nullptr) == 0)) {
+      return SORT_NONE;
+   }
+
+   if (size <= thresholds.insertionMaxSize) {
+      return SORT_INSERTION;
+   }
+
+   if (profile.InversionRatio() <= thresholds.presortedMaxRatio) {
+      return SORT_MERGE;
+   }
+
+   // A narrow sampled range still has to hold for every element
+   if ((double)profile.max - profile.min + 1 <= thresholds.countingMaxRange * size) {
+      low = profile.min;
+      high = profile.max;
+      if (!profile.exact) {
+         for (int pos = 0; pos < size; ++pos) {
+            if (data[pos] < low) {
+               low = data[pos];
+            }
+            if (data[pos] > high) {
+               high = data[pos];
+            }
+         }
+      }
+      if ((double)high - low + 1 <= thresholds.countingMaxRange * size) {
+         return SORT_COUNTING;
+      }
+   }
+
+   if (size >= thresholds.radixMinSize) {
+      return SORT_RADIX;
+   }
+   return SORT_QUICK;
+}
+
+SortChoice Sort(std::vector<int>* numbers, const SortThresholds& thresholds) {
+   NoCount counter;
+   return Sort(numbers, counter, thresholds);
+}
@@ -0,0 +1,111 @@
+// Selector
+//
+// Adaptive Sort(): profiles a sample of the input and runs the sort that is
+// expected to win on it. The crossover points live in SortThresholds, which
+// timealgorithms --calibrate measures on the host and saves as JSON.
+
+#ifndef SELECTOR_H
+#define SELECTOR_H
+
+#include <string>
+#include <vector>
+#include "counting.h"
+#include "insertionsort.h"
+#include "mergesort.h"
+#include "quicksort.h"
+#include "radixsort.h"
+
+// Inputs up to this size are profiled in full, larger ones by sampled blocks
+const int PROFILE_FULL_SCAN = 4096;
+
+// Number and length of the blocks sampled from larger inputs
+const int PROFILE_BLOCKS = 64;
+const int PROFILE_BLOCK_SIZE = 64;
+
+enum SortChoice {
+   SORT_NONE,        // Already sorted
+   SORT_INSERTION,
+   SORT_MERGE,       // Presorted input, natural merge sort
+   SORT_QUICK,
+   SORT_COUNTING,
+   SORT_RADIX,
+   NUM_SORT_CHOICES
+};
+
+const char* const SORT_CHOICE_NAMES[NUM_SORT_CHOICES] = {
+   "None", "InsertionSort", "MergeSort", "QuickSort", "CountingSort", "RadixSort"
+};
+
+/* Crossover points between the sorts. The defaults are reasonable on current
+ x86-64 machines; timealgorithms --calibrate measures them for the host. */
+struct SortThresholds {
+   int insertionMaxSize = 24;          // Insertion sort at or below this size
+   double presortedMaxRatio = 0.02;    // Merge sort when adjacent inversions per pair are at most this
+   double countingMaxRange = 2.0;      // Counting sort when (max - min + 1) / size is at most this
+   int radixMinSize = 1 << 11;         // Radix sort at or above this size
+};
+
+// Read thresholds saved by SaveSortThresholds, missing keys keep their defaults
+SortThresholds LoadSortThresholds(const std::string& filename);
+void SaveSortThresholds(const std::string& filename, const SortThresholds& thresholds);
+
+/* What a profile saw. For inputs above PROFILE_FULL_SCAN only PROFILE_BLOCKS
+ evenly spaced blocks are read, so inversions, min and max describe those
+ blocks and runs is extrapolated to the whole input. */
+struct InputProfile {
+   int size = 0;
+   int sampled = 0;            // Elements read
+   int pairs = 0;              // Adjacent pairs compared
+   long long inversions = 0;   // Adjacent pairs out of order
+   long long runs = 0;         // Estimated ascending runs in the whole input
+   int min = 0;
+   int max = 0;
+   bool exact = false;         // Whole input was read
+
+   double InversionRatio() const { return pairs > 0 ? (double)inversions / pairs : 0; }
+};
+
+InputProfile ProfileInput(const int* data, int size);
+
+/* Pick a sort for data from its profile. A sampled profile that looks sorted
+ or narrow is confirmed with a full scan before SORT_NONE or SORT_COUNTING is
+ returned; for SORT_COUNTING low and high are set to the exact value range. */
+SortChoice ChooseSort(const int* data, const InputProfile& profile, const SortThresholds& thresholds,
+                      int& low, int& high);
+
+/* Profile numbers, then sort it with the chosen algorithm and return the
+ choice. Only the sort itself is counted, not the profiling reads. */
+template <class Counter>
+SortChoice Sort(std::vector<int>* numbers, Counter& counter,
+                const SortThresholds& thresholds = SortThresholds()) {
+   InputProfile profile = ProfileInput(numbers->data(), numbers->size());
+   int low = 0;
+   int high = 0;
+   SortChoice choice = ChooseSort(numbers->data(), profile, thresholds, low, high);
+
+   switch (choice) {
+      case SORT_NONE:
+         break;
+      case SORT_INSERTION:
+         InsertionSortFast(numbers, counter);
+         break;
+      case SORT_MERGE:
+         MergeSortNatural(numbers, counter);
+         break;
+      case SORT_COUNTING:
+         CountingSort(numbers, low, high, counter);
+         break;
+      case SORT_RADIX:
+         RadixSort(numbers, counter);
+         break;
+      default:
+         QuickSortBlock(numbers, counter);
+         break;
+   }
+
+   return choice;
+}
+
+SortChoice Sort(std::vector<int>* numbers, const SortThresholds& thresholds = SortThresholds());
+
+#endif
@@ -1,110 +1,329 @@
 #include <iostream>       // for input/output streams (cout, cerr)
 #include <fstream>        // for file input/output (ifstream)
 #include <vector>         // for using vector data structure
+#include <climits>        // for INT_MAX and LLONG_MAX
+#include <cerrno>         // for errno and ERANGE
+#include <cstdlib>        // for strtoll
 #include "json.hpp"       // include the JSON library
+#include "samplereader.h" // include the streaming sample reader
+#include "threadpool.h"   // include the thread pool for parallel verification
+#include "verify.h"       // include the vectorized inversion scan
+#include "externalsort.h" // include the buffered int32 file reader
+#include "jsonwriter.h"   // include the streaming report writer
 
 using json = nlohmann::json;  // create shortcut for nlohmann::json
 using namespace std;          // use standard namespace
 
+// number of samples handed to the thread pool at a time, per thread
+// bounds how many parsed samples are held in memory at once
+const int SAMPLES_PER_THREAD = 4;
+
+// values read at a time when checking a raw int32 stream
+const size_t STREAM_CHUNK = 1 << 20;
+
+// a sample waiting to be verified, and its result once it has been
+struct SampleCheck {
+    string name;                 // sample name
+    Sample sample;               // the sample values
+    size_t inversion_count = 0;  // number of consecutive inversions found
+    vector<size_t> positions;    // positions of the reported inversions
+};
+
+// function to verify a batch of samples in parallel
+// results are written to output in batch order once every sample is done
+// max_inversions limits the reported positions per sample (0 reports all of them)
+// count_only reports just the number of inversions per sample
+void verifyBatch(vector<SampleCheck>& batch, ThreadPool& pool, size_t max_inversions, bool count_only,
+                 JsonWriter& output, int& samples_with_inversions) {
+    {
+        TaskGroup group(pool);  // one task per sample
+        for (SampleCheck& check : batch) {
+            SampleCheck* task_check = &check;  // pointer so the task does not copy the sample
+            group.Run([task_check, max_inversions, count_only] {
+                task_check->inversion_count = FindInversions(task_check->sample.data, task_check->sample.size, max_inversions,
+                                                             count_only ? nullptr : &task_check->positions);
+            });
+        }
+        group.Wait();  // wait for every sample to finish
+    }
+    
+    // collect the results
+    for (SampleCheck& check : batch) {
+        // skip samples without inversions
+        if (check.inversion_count == 0) {
+            continue;
+        }
+        samples_with_inversions++;  // increment counter of samples with inversions
+        
+        output.Key(check.name);  // one object per sample with inversions
+        output.BeginObject();
+        
+        // count-only mode skips the per-inversion JSON
+        if (count_only) {
+            output.Key("InversionCount");
+            output.UInt(check.inversion_count);  // number of inversions only
+            output.EndObject();
+            continue;
+        }
+        
+        const int* sample_array = check.sample.data;  // array data of the sample
+        
+        // write the inversions found in current sample
+        // positions go in the order the json DOM sorted their keys in, "10" before "9"
+        SortAsKeys(check.positions);
+        output.Key("ConsecutiveInversions");
+        output.BeginObject();
+        for (size_t i : check.positions) {
+            // key: index as string, Value: pair [current_element, next_element]
+            output.Key(i);
+            output.IntArray(sample_array + i, 2);
+        }
+        output.EndObject();
+        
+        if (max_inversions > 0) {
+            output.Key("InversionCount");
+            output.UInt(check.inversion_count);  // the report may be cut short, so give the full count
+        }
+        
+        output.Key("sample");
+        output.IntArray(sample_array, check.sample.size);  // include the entire sample array in output for reference, straight from the sample
+        output.EndObject();
+    }
+    batch.clear();  // release the samples
+}
+
+// function to verify a raw int32 file as one stream, a chunk at a time
+// the last value of each chunk is checked against the first value of the next
+// so inversions across chunk boundaries are found too
+// max_inversions and count_only work as they do for samples
+// the whole report is written to output, reported inversions as they are found
+void verifyStream(const string& filename, size_t max_inversions, bool count_only, JsonWriter& output) {
+    IntFileReader reader;
+    reader.Open(filename);
+    output.BeginObject();  // nothing is written unless the file opens
+
+    vector<int> chunk(STREAM_CHUNK + 1);  // one slot for the last value of the previous chunk
+    size_t offset = 0;                    // stream position of chunk[0]
+    size_t elements = 0;                  // values read so far
+    size_t inversion_count = 0;           // number of consecutive inversions found
+    bool reported = false;                // the ConsecutiveInversions object has been started
+
+    size_t count = reader.Read(chunk.data(), STREAM_CHUNK + 1);  // the first chunk has no carried value
+    while (count > 0) {
+        elements = offset + count;
+
+        // find inversions in this chunk, positions are relative to chunk[0]
+        vector<size_t> positions;
+        size_t limit = 0;  // positions still to report, 0 for all of them
+        if (max_inversions > 0) {
+            limit = inversion_count < max_inversions ? max_inversions - inversion_count : 0;
+        }
+        size_t found = FindInversions(chunk.data(), count, limit,
+                                      count_only || (max_inversions > 0 && limit == 0) ? nullptr : &positions);
+        inversion_count += found;
+        if (!positions.empty() && !reported) {
+            output.Key(filename);  // the stream has inversions, start its entry
+            output.BeginObject();
+            output.Key("ConsecutiveInversions");
+            output.BeginObject();
+            reported = true;
+        }
+        for (size_t i : positions) {
+            // key: index as string, Value: pair [current_element, next_element]
+            output.Key(offset + i);
+            output.IntArray(&chunk[i], 2);
+        }
+
+        // carry the last value over so the next chunk starts with it
+        chunk[0] = chunk[count - 1];
+        offset += count - 1;
+        count = reader.Read(chunk.data() + 1, STREAM_CHUNK);
+        if (count > 0) {
+            count++;  // include the carried value
+        }
+    }
+
+    if (inversion_count > 0) {
+        if (reported) {
+            output.EndObject();  // close ConsecutiveInversions
+        }
+        else {
+            output.Key(filename);  // count-only, or nothing was reported
+            output.BeginObject();
+        }
+        output.Key("InversionCount");
+        output.UInt(inversion_count);  // the report may be cut short, so give the full count
+        output.EndObject();
+    }
+
+    // add metadata section to output JSON with information about the verification
+    output.Key("metadata");
+    output.BeginObject();
+    output.Key("elements");
+    output.UInt(elements);  // number of values in the stream
+    output.Key("file");
+    output.String(filename);  // name of input file that was checked
+    output.Key("samplesWithInversions");
+    output.Int(inversion_count > 0 ? 1 : 0);  // the stream counts as one sample
+    output.EndObject();
+    output.EndObject();  // close the report
+}
+
+// parse a flag value as a whole number in [low, high]
+// returns false if it is not one, so a bad value is reported instead of aborting the program
+bool ParseNumber(const string& value, long long low, long long high, long long& number) {
+    char* end = nullptr;  // first character after the number
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > high) {
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
 int main(int argc, char** argv) {
     // check if correct number of command line arguments provided
-    // argc should be 2
-    // program name + input filename
-    if (argc != 2) {
-        cerr << "Usage: " << argv[0] << " <input.json>" << endl; // print error message to standard error
+    // argc should be at least 2
+    // program name + input filename, followed by the optional flags
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <input.json> [--threads N] [--first N] [--count-only] [--compact]" << endl; // print error message to standard error
+        cerr << "       " << argv[0] << " <input.raw> --stream [--first N] [--count-only] [--compact]" << endl;
+        cerr << "       samples are reported in the order they are checked, metadata last" << endl;
+        cerr << "       the report is streamed, after an error what was already written is partial" << endl;
         return 1;  // return error code 1 indicating failure
     }
     
+    int num_threads = 0;        // threads used to verify samples, 0 is one per hardware thread
+    size_t max_inversions = 0;  // inversions reported per sample, 0 reports all of them
+    bool count_only = false;    // report only the number of inversions per sample
+    bool stream = false;        // input is a raw int32 file checked as one stream
+    bool compact = false;       // write the report without indentation
+    for (int arg = 2; arg < argc; arg++) {
+        string flag = argv[arg];  // name of the flag
+        long long number = 0;     // value of a numeric flag
+        if ((flag == "--threads" || flag == "--first") && arg + 1 < argc &&
+            !ParseNumber(argv[arg + 1], 0, flag == "--threads" ? INT_MAX : LLONG_MAX, number)) {
+            cerr << "Error: Invalid value for " << flag << ": " << argv[arg + 1] << endl; // not a number or negative
+            return 1;  // return error code 1 indicating failure
+        }
+        if (flag == "--count-only") {
+            count_only = true;
+        }
+        else if (flag == "--stream") {
+            stream = true;
+        }
+        else if (flag == "--compact") {
+            compact = true;
+        }
+        else if (flag == "--threads" && arg + 1 < argc) {
+            num_threads = number;
+            ++arg;  // skip the value
+        }
+        else if (flag == "--first" && arg + 1 < argc) {
+            max_inversions = number;
+            ++arg;  // skip the value
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+    
     // store the filename from command line arguments
     // define it as a variable
     string filename = argv[1];  // argv[1] is the input JSON filename
     
-    // create input file stream object to read JSON file
-    ifstream input_file(filename);
-    
-    // check if file was successfully opened
-    if (!input_file.is_open()) {
-        cerr << "Error: Cannot open file " << filename << endl; // print error message if file cannot be opened
-        return 1;  // return error code 1 indicating failure
+    // a raw stream is checked with bounded memory, however large it is
+    if (stream) {
+        JsonWriter output(cout, !compact);  // the report is written as it is found
+        try {
+            verifyStream(filename, max_inversions, count_only, output);
+        } catch (const exception& e) {
+            output.Abandon();  // no unterminated report after what was already streamed
+            cerr << "Error: " << e.what() << endl; // print error message if the file cannot be read
+            return 1;  // return error code 1 indicating failure
+        }
+        return 0;
     }
-
-    // create JSON object to store parsed data
-    json data;
+    
+    // open the input file, samples are read one at a time below
+    SampleReader reader;
     try {
-        // parse the entire JSON file into the data object
-        input_file >> data;  // read and parse data from filestream
-    } catch (exception& e) {
-        
-        // handle JSON parsing errors (invalid JSON format)
-        cerr << "Error: Invalid JSON in file " << filename << endl;// print error message
+        reader.Open(filename);  // open the input JSON file
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl; // print error message if file cannot be opened
         return 1;  // return error code 1 indicating failure
     }
     
-    input_file.close(); // close file
-    
-    // create output JSON object that will contain our verification results
-    json output;
+    // the verification results are written to standard output sample by sample
+    // nothing but the current batch is held in memory
+    JsonWriter output(cout, !compact);  // 4-space indentation unless --compact
+    output.BeginObject();
     // tracker how many samples have consecutive inversions
     int samples_with_inversions = 0;
     
-    // extract metadata information from the input JSON
-    int arraySize = data["metadata"]["arraySize"];  // size of each array
-    int numSamples = data["metadata"]["numSamples"];  // number of samples
+    ThreadPool pool(num_threads);  // threads that verify the samples
+    vector<SampleCheck> batch;     // samples waiting to be verified
+    size_t batch_size = pool.NumThreads() * SAMPLES_PER_THREAD;  // samples verified together
     
-    // iterate through each key-value pair in the input JSON data using iterators
-    // auto it = data.begin() gets an iterator to the first element
-    for (auto it = data.begin(); it != data.end(); ++it) {
-        
-        // get the key (sample name) from current JSON element using iterator
-        string sample_name = it.key();
-        
-        // skip the metadata section
-        if (sample_name == "metadata") {
-            continue;  // skip to next iteration
-        }
-        
-        // extract the array data for current sample
-        vector<int> sample_array = it.value();
-        
-        // create JSON object 
-        // stores inversions found in current sample
-        json sample_inversions;
-        // tracker if current sample has any inversions
-        bool has_inversions = false;
-        
-        // loop through the sample array to check for consecutive inversions
-        // check from first element to second-to-last element
-        for (int i = 0; i < sample_array.size() - 1; i++) {
-            // check if current element is greater than next element (inversion found)
-            if (sample_array[i] > sample_array[i + 1]) {
-                // tracker becomes true
-                has_inversions = true;
-                
-                // add the inversion to sample_inversions JSON object
-                // key: index as string, Value: pair [current_element, next_element]
-                sample_inversions[to_string(i)] = {sample_array[i], sample_array[i + 1]};
+    // read each sample from the input file in turn, the reader skips the metadata section
+    while (true) {
+        batch.emplace_back();  // slot for the next sample
+        try {
+            if (!reader.Next(batch.back().name, batch.back().sample)) {
+                batch.pop_back();  // no samples left
+                break;
             }
+        } catch (const exception& e) {
+            // handle JSON parsing errors (invalid JSON format)
+            output.Abandon();  // no unterminated report after what was already streamed
+            cerr << "Error: " << e.what() << endl; // print error message
+            return 1;  // return error code 1 indicating failure
         }
         
-        // add inversions to JSON output
-        if (has_inversions) {
-            samples_with_inversions++;  // increment counter of samples with inversions
-            
-            output[sample_name]["ConsecutiveInversions"] = sample_inversions; // add ConsecutiveInversions object for this sample to output
-           
-            output[sample_name]["sample"] = sample_array;  // include the entire sample array in output for reference
+        // verify a full batch across the thread pool
+        if (batch.size() >= batch_size) {
+            try {
+                verifyBatch(batch, pool, max_inversions, count_only, output, samples_with_inversions);
+            } catch (const exception& e) {
+                output.Abandon();  // no unterminated report after what was already streamed
+                cerr << "Error: " << e.what() << endl; // print error message if the report cannot be written
+                return 1;  // return error code 1 indicating failure
+            }
         }
     }
     
-    // add metadata section to output JSON with information about the verification
-    output["metadata"]["arraySize"] = arraySize;  // size of arrays from input
-    output["metadata"]["file"] = filename;  // name of input file that was checked
-    output["metadata"]["numSamples"] = numSamples;  // total samples from input
-    output["metadata"]["samplesWithInversions"] = samples_with_inversions;  // count of problematic samples
+    try {
+        // verify whatever is left in the last batch
+        verifyBatch(batch, pool, max_inversions, count_only, output, samples_with_inversions);
     
-    // Print the final output JSON to standard output
-    // dump(4) formats to 4-space indentation
-    cout << output.dump(4) << endl;
+        // extract metadata information from the input JSON
+        // the metadata section is complete once every sample has been read
+        int arraySize = reader.Metadata().at("arraySize");  // size of each array
+        int numSamples = reader.Metadata().at("numSamples");  // number of samples
+    
+        // add metadata section to the output with information about the verification
+        // it goes last, after every sample
+        output.Key("metadata");
+        output.BeginObject();
+        output.Key("arraySize");
+        output.Int(arraySize);  // size of arrays from input
+        output.Key("file");
+        output.String(filename);  // name of input file that was checked
+        output.Key("numSamples");
+        output.Int(numSamples);  // total samples from input
+        output.Key("samplesWithInversions");
+        output.Int(samples_with_inversions);  // count of problematic samples
+        output.EndObject();
+    
+        // close the report, this flushes it to standard output
+        output.EndObject();
+    } catch (const exception& e) {
+        output.Abandon();  // no unterminated report after what was already streamed
+        cerr << "Error: " << e.what() << endl; // print error message if the report cannot be written
+        return 1;  // return error code 1 indicating failure
+    }
     
     return 0;  // Return 0 :)
 }
@@ -0,0 +1,158 @@
+// Thread Pool
+//
+// Work-stealing thread pool shared by the parallel sorts and tools.
+
+#include "threadpool.h"
+
+// Pool and slot of the current thread, set once when a worker starts
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local int current_index = -1;
+
+ThreadPool::ThreadPool(int num_threads) : queued_(0), stopping_(false) {
+   if (num_threads <= 0) {
+      num_threads = std::thread::hardware_concurrency();
+      if (num_threads <= 0) {
+         num_threads = 1;  // hardware_concurrency() may not know
+      }
+   }
+
+   for (int i = 0; i <= num_threads; ++i) {
+      queues_.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+   }
+   for (int i = 0; i < num_threads; ++i) {
+      workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+   }
+}
+
+ThreadPool::~ThreadPool() {
+   {
+      std::lock_guard<std::mutex> guard(sleep_lock_);
+      stopping_ = true;
+   }
+   wake_.notify_all();
+
+   for (std::thread& worker : workers_) {
+      worker.join();
+   }
+}
+
+int ThreadPool::ThreadIndex() const {
+   if (current_pool == this) {
+      return current_index;
+   }
+   return NumThreads();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+   int index = ThreadIndex();
+
+   {
+      std::lock_guard<std::mutex> guard(queues_[index]->lock);
+      queues_[index]->tasks.push_back(std::move(task));
+   }
+   queued_++;
+
+   // Take the sleep lock so a worker about to sleep cannot miss the wakeup
+   {
+      std::lock_guard<std::mutex> guard(sleep_lock_);
+   }
+   wake_.notify_one();
+}
+
+bool ThreadPool::PopTask(int index, std::function<void()>& task) {
+   int numQueues = queues_.size();
+
+   // Newest task from our own queue first, it is most likely still in cache
+   {
+      TaskQueue& own = *queues_[index];
+      std::lock_guard<std::mutex> guard(own.lock);
+      if (!own.tasks.empty()) {
+         task = std::move(own.tasks.back());
+         own.tasks.pop_back();
+         queued_--;
+         return true;
+      }
+   }
+
+   // Otherwise steal the oldest task from another queue
+   for (int offset = 1; offset < numQueues; ++offset) {
+      TaskQueue& victim = *queues_[(index + offset) % numQueues];
+      std::lock_guard<std::mutex> guard(victim.lock);
+      if (!victim.tasks.empty()) {
+         task = std::move(victim.tasks.front());
+         victim.tasks.pop_front();
+         queued_--;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+bool ThreadPool::RunPendingTask() {
+   std::function<void()> task;
+
+   if (queued_.load() == 0 || !PopTask(ThreadIndex(), task)) {
+      return false;
+   }
+   task();
+   return true;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+   std::function<void()> task;
+
+   current_pool = this;
+   current_index = index;
+
+   while (true) {
+      if (PopTask(index, task)) {
+         task();
+         task = nullptr;
+         continue;
+      }
+
+      std::unique_lock<std::mutex> guard(sleep_lock_);
+      wake_.wait(guard, [this] { return stopping_ || queued_.load() > 0; });
+      if (stopping_ && queued_.load() == 0) {
+         return;
+      }
+   }
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+   pending_++;
+   pool_.Submit([this, task] {
+      // Never let an exception out, a worker would terminate and Wait() would never return
+      try {
+         task();
+      } catch (...) {
+         std::lock_guard<std::mutex> guard(error_lock_);
+         if (!error_) {
+            error_ = std::current_exception();
+         }
+      }
+      pending_--;
+   });
+}
+
+void TaskGroup::Wait() {
+   std::exception_ptr error;
+
+   Drain();
+   {
+      std::lock_guard<std::mutex> guard(error_lock_);
+      error.swap(error_);
+   }
+   if (error) {
+      std::rethrow_exception(error);
+   }
+}
+
+void TaskGroup::Drain() {
+   while (pending_.load() > 0) {
+      if (!pool_.RunPendingTask()) {
+         std::this_thread::yield();
+      }
+   }
+}
@@ -0,0 +1,106 @@
+// Thread Pool
+//
+// Work-stealing thread pool shared by the parallel sorts and tools.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Each worker owns a deque of tasks. Workers push and pop at the back of their
+ own deque and steal from the front of the others' when they run dry. Tasks
+ submitted from outside the pool go to one extra shared deque. */
+class ThreadPool {
+public:
+   // num_threads of 0 uses one worker per hardware thread
+   explicit ThreadPool(int num_threads = 0);
+   ~ThreadPool();
+
+   ThreadPool(const ThreadPool&) = delete;
+   ThreadPool& operator=(const ThreadPool&) = delete;
+
+   int NumThreads() const { return (int)workers_.size(); }
+
+   // Slot of the calling thread: 0..NumThreads()-1 for workers, NumThreads() otherwise
+   int ThreadIndex() const;
+
+   void Submit(std::function<void()> task);
+
+   // Run one queued task on the calling thread, returns false if none was found
+   bool RunPendingTask();
+
+private:
+   struct TaskQueue {
+      std::mutex lock;
+      std::deque<std::function<void()>> tasks;
+   };
+
+   bool PopTask(int index, std::function<void()>& task);
+   void WorkerLoop(int index);
+
+   std::vector<std::thread> workers_;
+   std::vector<std::unique_ptr<TaskQueue>> queues_;  // One per worker plus the shared queue
+   std::mutex sleep_lock_;
+   std::condition_variable wake_;
+   std::atomic<int> queued_;
+   bool stopping_;
+};
+
+/* Tasks that are waited on together. Wait() runs queued tasks on the waiting
+ thread instead of blocking, so groups can be nested inside pool tasks. An
+ exception thrown by a task (a comparator or projection, say) is caught on
+ whichever thread ran it; the other tasks still run to completion and Wait()
+ rethrows the first exception. */
+class TaskGroup {
+public:
+   explicit TaskGroup(ThreadPool& pool) : pool_(pool), pending_(0) {}
+   ~TaskGroup() { Drain(); }
+
+   void Run(std::function<void()> task);
+   void Wait();
+
+private:
+   void Drain();   // Wait for every task without rethrowing
+
+   ThreadPool& pool_;
+   std::atomic<int> pending_;
+   std::mutex error_lock_;
+   std::exception_ptr error_;   // First exception thrown by a task
+};
+
+/* Counting policy (counting.h) kept per pool thread so tasks never contend on
+ it. Total() combines the slots once the work is done. */
+template <class Counter>
+class ThreadCounters {
+public:
+   explicit ThreadCounters(const ThreadPool& pool)
+      : pool_(pool), slots_(pool.NumThreads() + 1) {}
+
+   void Add(const Counter& counter) { slots_[pool_.ThreadIndex()].counter.Add(counter); }
+
+   Counter Total() const {
+      Counter total;
+      for (const Slot& slot : slots_) {
+         total.Add(slot.counter);
+      }
+      return total;
+   }
+
+private:
+   struct alignas(64) Slot {
+      Counter counter;
+   };
+
+   const ThreadPool& pool_;
+   std::vector<Slot> slots_;
+};
+
+#endif
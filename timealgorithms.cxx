@@ -1,115 +1,517 @@
 #include <iostream>       // for input/output streams (cout, cerr)
-#include <fstream>        // for file input/output (ifstream)
+#include <fstream>        // for file input/output (ofstream)
 #include <vector>         // for using vector data structure
-#include <ctime>          // for timing functions (clock())
+#include <random>         // for the random calibration inputs
+#include <climits>        // for INT_MAX
+#include <cerrno>         // for errno and ERANGE
+#include <cstdlib>        // for strtoll
+#include <algorithm>      // for sort, max and minmax_element
 #include "json.hpp"       // include the JSON library for parsing/creating JSON
+#include "samplereader.h"  // include the streaming sample reader
+#include "benchmark.h"     // include the timing harness
 #include "insertionsort.h" // include the insertion sort algorithm
 #include "mergesort.h"     // include the merge sort algorithm  
 #include "quicksort.h"     // include the quick sort algorithm
+#include "radixsort.h"     // include the radix sort algorithm
+#include "selector.h"      // include the adaptive sort and its thresholds
+#include "verify.h"        // include the inversion count used by calibration
+#include "batchsort.h"     // include the batched sorts for the counting runs
+#include "perfcounters.h"  // include the hardware event counters
 
 using json = nlohmann::json;  // create shortcut for nlohmann::json
 using namespace std;          // use standard namespace
 
-// function to read and parse a JSON file
-json readJSONFile(const string& filename) {
-    // create input file stream object to read the JSON file
-    ifstream input_file(filename);
-    // check if file was successfully opened
-    if (!input_file.is_open()) {
-        // throw error if file cannot be opened
-        throw runtime_error("Cannot open file: " + filename);
+// a sorting algorithm timed by this program
+struct Algorithm {
+    string name;                                  // column prefix in the CSV header
+    void (*sort)(vector<int>*, NoCount&);         // the uninstrumented sort, this is what gets timed
+    void (*count)(vector<int>*, PhaseHistogram&); // the same sort counting comparisons and memory accesses per phase
+    bool in_csv;                                  // has columns in the CSV on standard output, otherwise only in --extended and --json
+};
+
+// every algorithm in CSV column order
+const Algorithm ALGORITHMS[] = {
+    {"InsertionSort", InsertionSort<NoCount>, InsertionSort<PhaseHistogram>, true},
+    {"MergeSort", MergeSort<NoCount>, MergeSort<PhaseHistogram>, true},
+    {"QuickSort", QuickSort<NoCount>, QuickSort<PhaseHistogram>, true},
+    {"RadixSort", RadixSort<NoCount>, RadixSort<PhaseHistogram>, true},
+    // the CSV keeps its required columns, the multiway sort is reported with its passes in the detailed outputs
+    {"MergeSortMultiway", [](vector<int>* v, NoCount& c) { MergeSortMultiway(v, c); },
+     [](vector<int>* v, PhaseHistogram& c) { MergeSortMultiway(v, c); }, false},
+};
+
+SortThresholds adaptive_thresholds;  // thresholds the AdaptiveSort column runs with
+
+// the adaptive Sort() with the thresholds given by --thresholds
+template <class Counter>
+void AdaptiveSort(vector<int>* numbers, Counter& counter) {
+    Sort(numbers, counter, adaptive_thresholds);
+}
+
+const int CALIBRATION_ELEMENTS = 1 << 16;  // elements sorted per timed calibration run
+
+// number of samples read and counted together, per counting thread
+const int SAMPLES_PER_THREAD = 4;
+
+// hardware event columns requested with --perf
+struct PerfColumns {
+    vector<PerfEvent> events;  // events in column order, empty without --perf
+    PerfCounters counters;     // counters on the timing thread
+};
+
+// parse the --perf value: "all" or a comma-separated list of event names such as Cycles,BranchMisses
+// returns false if a name is not an event
+bool ParsePerfEvents(const string& value, vector<PerfEvent>& events) {
+    if (value == "all") {
+        for (int event = 0; event < NUM_PERF_EVENTS; ++event) {
+            events.push_back((PerfEvent)event);
+        }
+        return true;
+    }
+    size_t start = 0;  // start of the current name
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);  // end of the current name
+        if (end == string::npos) {
+            end = value.size();
+        }
+        string name = value.substr(start, end - start);  // the event name
+        int event = 0;
+        while (event < NUM_PERF_EVENTS && name != PERF_EVENT_NAMES[event]) {
+            event++;
+        }
+        if (event == NUM_PERF_EVENTS) {
+            return false;  // unknown event
+        }
+        events.push_back((PerfEvent)event);
+        start = end + 1;
+    }
+    return true;
+}
+
+// parse a flag value as a whole number in [low, high]
+// returns false if it is not one, so a bad value is reported instead of aborting the program
+bool ParseNumber(const string& value, long long low, long long high, long long& number) {
+    char* end = nullptr;  // first character after the number
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < low || parsed > high) {
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
+// count random arrays of the given size with values in [0, range), or any int for range 0
+vector<vector<int>> RandomInputs(mt19937& rng, int count, int size, long long range) {
+    vector<vector<int>> inputs(count, vector<int>(size));
+    for (vector<int>& input : inputs) {
+        for (int& value : input) {
+            value = range > 0 ? (int)(rng() % range) : (int)rng();
+        }
+    }
+    return inputs;
+}
+
+// median time to sort every input once
+double MedianTime(const vector<vector<int>>& inputs, void (*sort)(vector<int>*, NoCount&),
+                  const BenchmarkOptions& options) {
+    vector<vector<int>> work;  // copies that are sorted, restored before every run
+    return TimeSortBatch(inputs, work, [&](vector<int>* numbers) {
+        NoCount counter;
+        sort(numbers, counter);
+    }, options).median;
+}
+
+// the sorts Sort() can dispatch to, without their extra parameters
+void InsertionPath(vector<int>* numbers, NoCount& counter) { InsertionSortFast(numbers, counter); }
+void MergePath(vector<int>* numbers, NoCount& counter) { MergeSortNatural(numbers, counter); }
+void QuickPath(vector<int>* numbers, NoCount& counter) { QuickSortBlock(numbers, counter); }
+void RadixPath(vector<int>* numbers, NoCount& counter) { RadixSort(numbers, counter); }
+
+// counting sort over the exact value range of numbers
+void CountingPath(vector<int>* numbers, NoCount& counter) {
+    if (numbers->empty()) {
+        return;
+    }
+    auto range = minmax_element(numbers->begin(), numbers->end());
+    CountingSort(numbers, *range.first, *range.second, counter);
+}
+
+// measure the crossover points of Sort() on this machine, one threshold at a time
+SortThresholds Calibrate(const BenchmarkOptions& options) {
+    SortThresholds thresholds;  // learned thresholds
+    mt19937 rng(12345);         // fixed seed so calibration runs are comparable
+
+    // every scan keeps the last size, range or ratio where the candidate won,
+    // so one noisy measurement near a tie does not end the scan early
+
+    // largest size where insertion sort still beats introsort on random data
+    thresholds.insertionMaxSize = 1;
+    for (int size = 4; size <= 512; size *= 2) {
+        vector<vector<int>> inputs = RandomInputs(rng, CALIBRATION_ELEMENTS / size, size, 0);
+        if (MedianTime(inputs, InsertionPath, options) <= MedianTime(inputs, QuickPath, options)) {
+            thresholds.insertionMaxSize = size;
+        }
+    }
+
+    // smallest size from which radix sort beats introsort on random data at every larger size
+    thresholds.radixMinSize = INT_MAX;
+    for (int size = 64; size <= (1 << 20); size *= 2) {
+        vector<vector<int>> inputs = RandomInputs(rng, max(1, CALIBRATION_ELEMENTS / size), size, 0);
+        if (MedianTime(inputs, RadixPath, options) >= MedianTime(inputs, QuickPath, options)) {
+            thresholds.radixMinSize = INT_MAX;  // lost, any earlier win was noise
+        }
+        else if (thresholds.radixMinSize == INT_MAX) {
+            thresholds.radixMinSize = size;
+        }
+    }
+
+    // the general-purpose sort Sort() falls back to at CALIBRATION_ELEMENTS
+    void (*general)(vector<int>*, NoCount&) = CALIBRATION_ELEMENTS >= thresholds.radixMinSize ? RadixPath : QuickPath;
+
+    // widest value range (relative to the size) where counting sort still wins
+    thresholds.countingMaxRange = 0;
+    for (double factor = 1.0 / 16; factor <= 64; factor *= 2) {
+        vector<vector<int>> inputs = RandomInputs(rng, 1, CALIBRATION_ELEMENTS, (long long)(factor * CALIBRATION_ELEMENTS));
+        if (MedianTime(inputs, CountingPath, options) <= MedianTime(inputs, general, options)) {
+            thresholds.countingMaxRange = factor;
+        }
+    }
+
+    // most adjacent inversions per pair where the presorted path still wins
+    thresholds.presortedMaxRatio = 0;
+    for (double ratio = 0.001; ratio <= 0.5; ratio *= 2) {
+        vector<vector<int>> inputs = RandomInputs(rng, 1, CALIBRATION_ELEMENTS, 0);
+        vector<int>& input = inputs[0];
+        sort(input.begin(), input.end());
+        // each random swap adds about two adjacent inversions
+        for (int swap_count = (int)(ratio * CALIBRATION_ELEMENTS / 2); swap_count > 0; --swap_count) {
+            std::swap(input[rng() % CALIBRATION_ELEMENTS], input[rng() % CALIBRATION_ELEMENTS]);
+        }
+        if (MedianTime(inputs, MergePath, options) <= MedianTime(inputs, general, options)) {
+            thresholds.presortedMaxRatio = (double)FindInversions(input.data(), input.size(), 0, nullptr) / (input.size() - 1);
+        }
+    }
+
+    return thresholds;
+}
+
+// function to time a batch of samples with every algorithm and print one CSV row per sample
+// the untimed counting runs of the whole batch go across the thread pool first, one sample per task,
+// then each sample is timed on this thread as before, so the rows and counters stay in input order
+// samples are never split across threads here: a parallel sort would change the counts
+void timeBatch(const vector<string>& names, const vector<vector<int>>& arrays, const vector<Algorithm>& algorithms,
+               BatchSorter<PhaseHistogram>& counter_batch, vector<int>& work_array, const BenchmarkOptions& options,
+               PerfColumns& perf, ofstream& extended_file, json* json_output) {
+    // counts[algorithm][sample] from the counted sorts
+    vector<vector<PhaseHistogram>> counts(algorithms.size());
+    for (size_t a = 0; a < algorithms.size(); a++) {
+        counter_batch.Sort(arrays, algorithms[a].count);
+        for (size_t s = 0; s < arrays.size(); s++) {
+            counts[a].push_back(counter_batch.Counts(s));
+        }
     }
     
-    // create JSON object to store parsed data
-    json data;
-    try {
-        // parse the entire JSON file into the data object
-        input_file >> data;  //  reads and parses from filestream
-    } catch (exception& e) {
-        // throw error for invalid JSON format
-        throw runtime_error("Invalid JSON in file: " + filename);
-    }
-    input_file.close(); // close input file
-    return data;  // return the parsed JSON data
+    for (size_t s = 0; s < arrays.size(); s++) {
+        const string& sample_name = names[s];  // name of the current sample
+        
+        // print the sample name for the current CSV row
+        cout << sample_name;
+        
+        // test each algorithm
+        for (size_t a = 0; a < algorithms.size(); a++) {
+            const Algorithm& algorithm = algorithms[a];  // the algorithm being timed
+            
+            // every run restores work_array from the original array, outside the timed region
+            // the timed runs use the uninstrumented sort, so counting costs nothing here
+            TimingStats stats = TimeSort(arrays[s], work_array, [&](vector<int>* numbers) {
+                NoCount counter;
+                algorithm.sort(numbers, counter);
+            }, options);
+        
+            // the counted run of this sample from the batch, for the comparison and memory access columns
+            const PhaseHistogram& sample_counts = counts[a][s];
+            long long compares = sample_counts.TotalCompares();   // 64-bit counter for comparisons
+            long long memaccess = sample_counts.TotalAccesses();  // 64-bit counter for memory accesses
+            long long passes = sample_counts.pass_count;          // full passes over the array, 0 for sorts that do not stream it
+        
+            // output results for CSV, the time column is the median run
+            if (algorithm.in_csv) {
+                cout << "," << stats.median << "," << compares << "," << memaccess;
+            }
+        
+            // hardware events per sort call, averaged over as many runs as were timed
+            // an event the machine cannot count leaves its column empty
+            PerfReading reading;
+            if (!perf.events.empty()) {
+                reading = CountSortEvents(arrays[s], work_array, [&](vector<int>* numbers) {
+                    NoCount counter;
+                    algorithm.sort(numbers, counter);
+                }, perf.counters, options.repetitions);
+            }
+            for (PerfEvent event : perf.events) {
+                if (!algorithm.in_csv) {
+                    break;  // the detailed outputs get the readings below
+                }
+                cout << ",";
+                if (reading.available[event]) {
+                    cout << reading.values[event];
+                }
+            }
+        
+            // output the full statistics if requested
+            if (extended_file.is_open()) {
+                extended_file << sample_name << "," << algorithm.name << "," << options.repetitions << ","
+                              << stats.min << "," << stats.median << "," << stats.p95 << ","
+                              << stats.mean << "," << stats.stddev << "," << compares << "," << memaccess << ","
+                              << passes << endl;
+            }
+            if (json_output != nullptr) {
+                json& entry = (*json_output)[sample_name][algorithm.name];  // results for this sample and algorithm
+                entry["runs"] = stats.runs;
+                entry["min"] = stats.min;
+                entry["median"] = stats.median;
+                entry["p95"] = stats.p95;
+                entry["mean"] = stats.mean;
+                entry["stddev"] = stats.stddev;
+                entry["compares"] = compares;
+                entry["memaccess"] = memaccess;
+                if (passes != 0) {
+                    entry["passes"] = passes;  // only the sorts that count their passes
+                }
+                for (PerfEvent event : perf.events) {
+                    if (reading.available[event]) {
+                        entry["perf"][PERF_EVENT_NAMES[event]] = reading.values[event];
+                    }
+                }
+                for (int phase = 0; phase < NUM_SORT_PHASES; ++phase) {
+                    if (sample_counts.comp_count[phase] != 0 || sample_counts.mem_count[phase] != 0) {
+                        entry["phases"][SORT_PHASE_NAMES[phase]]["compares"] = sample_counts.comp_count[phase];
+                        entry["phases"][SORT_PHASE_NAMES[phase]]["memaccess"] = sample_counts.mem_count[phase];
+                    }
+                }
+            }
+        }
+        cout << endl;
+    }
 }
 
 int main(int argc, char** argv) {
     // check if correct number of command line arguments provided
-    // argc should be 2
-    // program name + input filename
-    if (argc != 2) {
-        cerr << "Usage: " << argv[0] << " <input.json>" << endl; // print error message to standard error
+    // argc should be at least 2
+    // program name + input filename, followed by the optional flags
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <input.json> [--warmup N] [--reps N] [--pin CPU]"
+             << " [--extended out.csv] [--json out.json] [--thresholds in.json|default] [--threads N]"
+             << " [--perf all|Cycles,Instructions,BranchMisses,L1dMisses,LlcMisses,PageFaults]" << endl; // print error message to standard error
+        cerr << "       " << argv[0] << " --calibrate out.json [--warmup N] [--reps N] [--pin CPU]" << endl;
         return 1;  // return error code 1 indicating failure
     }
     
     // store the filename from command line arguments
     // define a variable
-    string filename = argv[1];  // argv[1] contains the input JSON filename
+    string filename;            // input JSON filename, the one argument that is not a flag
+
+    BenchmarkOptions options;   // warm-up runs, timed runs and CPU pinning
+    string extended_filename;   // optional CSV with statistics per sample and algorithm
+    string json_filename;       // optional JSON with the same statistics
+    string thresholds_filename; // optional thresholds for an AdaptiveSort column
+    string calibrate_filename;  // where to save calibrated thresholds, replaces the normal run
+    int num_threads = 0;        // threads for the untimed counting runs, 0 is one per hardware thread
+    PerfColumns perf;           // hardware event columns, none unless --perf is given
+    for (int arg = 1; arg < argc; arg += 2) {
+        string flag = argv[arg];  // name of the flag
+        if (flag.compare(0, 2, "--") != 0) {
+            filename = flag;  // the input file
+            --arg;            // it has no value to skip
+            continue;
+        }
+        if (arg + 1 >= argc) {
+            cerr << "Error: Missing value for " << flag << endl; // every flag takes a value
+            return 1;  // return error code 1 indicating failure
+        }
+        string value = argv[arg + 1];  // value of the flag
+        long long number = 0;          // value of a numeric flag
+        bool numeric = flag == "--warmup" || flag == "--reps" || flag == "--threads";  // counts, never negative
+        if ((numeric && !ParseNumber(value, 0, INT_MAX, number)) ||
+            (flag == "--pin" && !ParseNumber(value, -1, INT_MAX, number))) {
+            cerr << "Error: Invalid value for " << flag << ": " << value << endl; // not a number or out of range
+            return 1;  // return error code 1 indicating failure
+        }
+        if (flag == "--warmup") {
+            options.warmup = number;
+        }
+        else if (flag == "--reps") {
+            options.repetitions = number;
+        }
+        else if (flag == "--pin") {
+            options.cpu = number;  // -1 leaves the thread unpinned
+        }
+        else if (flag == "--extended") {
+            extended_filename = value;
+        }
+        else if (flag == "--json") {
+            json_filename = value;
+        }
+        else if (flag == "--thresholds") {
+            thresholds_filename = value;
+        }
+        else if (flag == "--calibrate") {
+            calibrate_filename = value;
+        }
+        else if (flag == "--threads") {
+            num_threads = number;
+        }
+        else if (flag == "--perf") {
+            if (!ParsePerfEvents(value, perf.events)) {
+                cerr << "Error: Unknown event in --perf " << value << endl; // print error message for unknown events
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        else {
+            cerr << "Error: Unknown option " << flag << endl; // print error message for unknown flags
+            return 1;  // return error code 1 indicating failure
+        }
+    }
+    if (options.repetitions < 1) {
+        cerr << "Error: --reps must be at least 1" << endl; // need at least one timed run
+        return 1;  // return error code 1 indicating failure
+    }
+
+    // pin to one CPU so runs are not migrated between cores mid-measurement
+    if (options.cpu >= 0 && !PinToCpu(options.cpu)) {
+        cerr << "Warning: Cannot pin to CPU " << options.cpu << endl; // keep going unpinned
+    }
+
+    // calibration mode: learn the thresholds of Sort() on this machine and save them
+    if (!calibrate_filename.empty()) {
+        try {
+            SortThresholds thresholds = Calibrate(options);
+            SaveSortThresholds(calibrate_filename, thresholds);
+            cout << "insertionMaxSize," << thresholds.insertionMaxSize << endl;
+            cout << "presortedMaxRatio," << thresholds.presortedMaxRatio << endl;
+            cout << "countingMaxRange," << thresholds.countingMaxRange << endl;
+            cout << "radixMinSize," << thresholds.radixMinSize << endl;
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl; // print error message if the thresholds cannot be saved
+            return 1;  // return error code 1 indicating failure
+        }
+        return 0;
+    }
+    if (filename.empty()) {
+        cerr << "Error: Missing input file" << endl; // need a file unless calibrating
+        return 1;  // return error code 1 indicating failure
+    }
+
+    // open the hardware counters on this thread, the one the sorts run on
+    // containers and restrictive perf_event_paranoid settings often refuse some or all of them, so keep going without
+    if (!perf.events.empty()) {
+        perf.counters.Open();
+        if (!perf.counters.Error().empty()) {
+            cerr << "Warning: Event counters unavailable (" << perf.counters.Error() << "), their columns are left empty" << endl;
+        }
+    }
+
+    // the sorts to time, plus the adaptive sort when thresholds are given
+    // columns that only the detailed outputs have are timed only when one of them is written
+    vector<Algorithm> algorithms;
+    for (const Algorithm& algorithm : ALGORITHMS) {
+        if (algorithm.in_csv || !extended_filename.empty() || !json_filename.empty()) {
+            algorithms.push_back(algorithm);
+        }
+    }
+    if (!thresholds_filename.empty()) {
+        if (thresholds_filename != "default") {
+            try {
+                adaptive_thresholds = LoadSortThresholds(thresholds_filename);
+            } catch (const exception& e) {
+                cerr << "Error: " << e.what() << endl; // print error message if the thresholds cannot be read
+                return 1;  // return error code 1 indicating failure
+            }
+        }
+        algorithms.push_back({"AdaptiveSort", AdaptiveSort<NoCount>, AdaptiveSort<PhaseHistogram>, true});
+    }
     
-    // create object to store data that was read
-    json data;
+    // open the input file, samples are read one at a time below
+    SampleReader reader;
     try {
-        data = readJSONFile(filename);  // read the input JSON file
+        reader.Open(filename);  // open the input JSON file
     } catch (const exception& e) {
         cerr << "Error: " << e.what() << endl; // print error message if file reading fails
         return 1;  // return error code 1 indicating failure
     }
     
+    // open the extended CSV output if requested
+    ofstream extended_file;
+    if (!extended_filename.empty()) {
+        extended_file.open(extended_filename);
+        if (!extended_file.is_open()) {
+            cerr << "Error: Cannot open file " << extended_filename << endl; // print error message if file cannot be opened
+            return 1;  // return error code 1 indicating failure
+        }
+        extended_file << "Sample,Algorithm,Repetitions,Min,Median,P95,Mean,Stddev,Compares,Memaccess,Passes" << endl;
+    }
+    json json_output;  // statistics for the JSON output
+
     // print CSV header row with required column names
-    cout << "Sample,InsertionSortTime,InsertionSortCompares,InsertionSortMemaccess,";
-    cout << "MergeSortTime,MergeSortCompares,MergeSortMemaccess,";
-    cout << "QuickSortTime,QuickSortCompares,QuickSortMemaccess" << endl;
+    cout << "Sample";
+    for (const Algorithm& algorithm : algorithms) {
+        if (!algorithm.in_csv) {
+            continue;  // reported in --extended and --json only
+        }
+        cout << "," << algorithm.name << "Time," << algorithm.name << "Compares," << algorithm.name << "Memaccess";
+        for (PerfEvent event : perf.events) {
+            cout << "," << algorithm.name << PERF_EVENT_NAMES[event];
+        }
+    }
+    cout << endl;
     
-    // process each sample in the JSON file
-    for (auto it = data.begin(); it != data.end(); ++it) {
-        string sample_name = it.key();  // get the sample name from current element
+    BatchSorter<PhaseHistogram> counter_batch(num_threads);  // runs the counted sorts of a batch across threads
+    size_t batch_size = counter_batch.Pool().NumThreads() * SAMPLES_PER_THREAD;  // samples read together
+    vector<string> batch_names;         // names of the samples in the batch
+    vector<vector<int>> batch_arrays;   // original arrays of the samples in the batch, reused by later batches
+    vector<int> work_array;             // copy that is sorted, reused across algorithms and runs
         
-        // skip metadata section 
-        if (sample_name == "metadata") {
-            continue;  // skip to next iteration of the loop
+    // process the samples in the JSON file a batch at a time, the reader skips the metadata section
+    bool more = true;
+    while (more) {
+        size_t count = 0;  // samples read into this batch
+        try {
+            while (count < batch_size) {
+                if (count == batch_arrays.size()) {
+                    batch_names.emplace_back();
+                    batch_arrays.emplace_back();
+                }
+                if (!reader.Next(batch_names[count], batch_arrays[count])) {
+                    more = false;  // no samples left
+                    break;
+                }
+                count++;
+            }
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl; // print error message if the file is malformed
+            return 1;  // return error code 1 indicating failure
         }
         
-        // get the original array for this sample
-        vector<int> original_array = it.value();  // extract the array from JSON
-        
-        // print the sample name for the current CSV row
-        cout << sample_name << ",";
-        
-        // test Insertion Sort
-        vector<int> insertion_array = original_array;  // create copy for insertion sort
-        int insertion_compares = 0;  // counter for insertion sort comparisons
-        int insertion_memaccess = 0; // counter for insertion sort memory accesses
-        clock_t insertion_start = clock();  // start timing insertion sort
-        InsertionSort(&insertion_array, insertion_compares, insertion_memaccess);  // run insertion sort
-        clock_t insertion_end = clock();  // end timing insertion sort
-        double insertion_time = double(insertion_end - insertion_start) / CLOCKS_PER_SEC;  // calculate time
-        
-        // output Insertion Sort results for CSV
-        cout << insertion_time << "," << insertion_compares << "," << insertion_memaccess << ",";
-        
-        // test Merge Sort  
-        vector<int> merge_array = original_array;  // create copy for merge sort
-        int merge_compares = 0;  // counter for merge sort comparisons
-        int merge_memaccess = 0; // counter for merge sort memory accesses
-        clock_t merge_start = clock();  // start timing merge sort
-        MergeSort(&merge_array, merge_compares, merge_memaccess);  // run merge sort
-        clock_t merge_end = clock();  // end timing merge sort
-        double merge_time = double(merge_end - merge_start) / CLOCKS_PER_SEC;  // calculate time
-        
-        // output Merge Sort results for CSV
-        cout << merge_time << "," << merge_compares << "," << merge_memaccess << ",";
+        // drop the slots of the last, partial batch so the batch sorter only sees real samples
+        batch_names.resize(count);
+        batch_arrays.resize(count);
+        timeBatch(batch_names, batch_arrays, algorithms, counter_batch, work_array, options, perf,
+                  extended_file, json_filename.empty() ? nullptr : &json_output);
+    }
         
-        // test Quick Sort
-        vector<int> quick_array = original_array;  // create copy for quick sort
-        int quick_compares = 0;  // counter for quick sort comparisons
-        int quick_memaccess = 0; // counter for quick sort memory accesses
-        clock_t quick_start = clock();  // start timing quick sort
-        QuickSort(&quick_array, quick_compares, quick_memaccess);  // run quick sort
-        clock_t quick_end = clock();  // end timing quick sort
-        double quick_time = double(quick_end - quick_start) / CLOCKS_PER_SEC;  // calculate time
+    // write the JSON statistics if requested
+    if (!json_filename.empty()) {
+        json_output["metadata"]["file"] = filename;  // name of input file that was timed
+        json_output["metadata"]["warmup"] = options.warmup;  // untimed runs per sort
+        json_output["metadata"]["repetitions"] = options.repetitions;  // timed runs per sort
         
-        // output results for CSV
-        cout << quick_time << "," << quick_compares << "," << quick_memaccess << endl;
+        ofstream json_file(json_filename);
+        if (!json_file.is_open()) {
+            cerr << "Error: Cannot open file " << json_filename << endl; // print error message if file cannot be opened
+            return 1;  // return error code 1 indicating failure
+        }
+        json_file << json_output.dump(4) << endl;  // dump(4) for 4-space indent
     }
     
     return 0;  // Return 0 :)
@@ -0,0 +1,114 @@
+// Verify
+//
+// Vectorized kernels behind the verification tools.
+
+#include "verify.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+bool SamplesEqual(const int* a, const int* b, size_t size) {
+   return size == 0 || memcmp(a, b, size * sizeof(int)) == 0;
+}
+
+size_t FindMismatches(const int* a, const int* b, size_t size, size_t limit,
+                      std::vector<size_t>* positions) {
+   size_t count = 0;
+   size_t pos = 0;
+   size_t blockEnd = 0;
+
+   while (pos < size) {
+      // Skip whole blocks of equal values
+#if defined(__AVX2__)
+      while (pos + 8 <= size) {
+         __m256i left = _mm256_loadu_si256((const __m256i*)(a + pos));
+         __m256i right = _mm256_loadu_si256((const __m256i*)(b + pos));
+         if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(left, right)) != -1) {
+            break;
+         }
+         pos += 8;
+      }
+      blockEnd = pos + 8 < size ? pos + 8 : size;
+#elif defined(__SSE2__)
+      while (pos + 4 <= size) {
+         __m128i left = _mm_loadu_si128((const __m128i*)(a + pos));
+         __m128i right = _mm_loadu_si128((const __m128i*)(b + pos));
+         if (_mm_movemask_epi8(_mm_cmpeq_epi32(left, right)) != 0xFFFF) {
+            break;
+         }
+         pos += 4;
+      }
+      blockEnd = pos + 4 < size ? pos + 4 : size;
+#else
+      blockEnd = size;
+#endif
+
+      // Scalar scan of the block that differs (or the tail)
+      for (; pos < blockEnd; ++pos) {
+         if (a[pos] != b[pos]) {
+            if (positions != nullptr && (limit == 0 || count < limit)) {
+               positions->push_back(pos);
+            }
+            ++count;
+         }
+      }
+   }
+
+   return count;
+}
+
+size_t FindInversions(const int* data, size_t size, size_t limit,
+                      std::vector<size_t>* positions) {
+   size_t count = 0;
+   size_t pos = 0;
+   size_t blockEnd = 0;
+
+   if (size < 2) {
+      return 0;
+   }
+
+   // pos runs over the left element of each adjacent pair, 0..size-2
+   while (pos + 1 < size) {
+      // Skip whole blocks that are in order
+#if defined(__AVX2__)
+      while (pos + 9 <= size) {
+         __m256i left = _mm256_loadu_si256((const __m256i*)(data + pos));
+         __m256i right = _mm256_loadu_si256((const __m256i*)(data + pos + 1));
+         if (!_mm256_movemask_epi8(_mm256_cmpgt_epi32(left, right))) {
+            pos += 8;
+            continue;
+         }
+         break;
+      }
+      blockEnd = pos + 8 < size - 1 ? pos + 8 : size - 1;
+#elif defined(__SSE2__)
+      while (pos + 5 <= size) {
+         __m128i left = _mm_loadu_si128((const __m128i*)(data + pos));
+         __m128i right = _mm_loadu_si128((const __m128i*)(data + pos + 1));
+         if (!_mm_movemask_epi8(_mm_cmpgt_epi32(left, right))) {
+            pos += 4;
+            continue;
+         }
+         break;
+      }
+      blockEnd = pos + 4 < size - 1 ? pos + 4 : size - 1;
+#else
+      blockEnd = size - 1;
+#endif
+
+      // Scalar scan of the block with an inversion (or the tail)
+      for (; pos < blockEnd; ++pos) {
+         if (data[pos] > data[pos + 1]) {
+            if (positions != nullptr && (limit == 0 || count < limit)) {
+               positions->push_back(pos);
+            }
+            ++count;
+         }
+      }
+   }
+
+   return count;
+}
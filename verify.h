@@ -0,0 +1,26 @@
+// Verify
+//
+// Vectorized kernels behind the verification tools.
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <cstddef>
+#include <vector>
+
+// True if a[0..size-1] and b[0..size-1] hold the same values
+bool SamplesEqual(const int* a, const int* b, size_t size);
+
+/* Count the positions where a and b differ, appending the first limit of them
+ to positions (limit 0 records every position, a null positions only counts).
+ Equal stretches are skipped a vector register at a time. */
+size_t FindMismatches(const int* a, const int* b, size_t size, size_t limit,
+                      std::vector<size_t>* positions);
+
+/* Count the positions i where data[i] > data[i + 1], appending the first
+ limit of them to positions as FindMismatches() does. Adjacent pairs are
+ compared a vector register at a time. */
+size_t FindInversions(const int* data, size_t size, size_t limit,
+                      std::vector<size_t>* positions);
+
+#endif
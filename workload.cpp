@@ -0,0 +1,203 @@
+// Workload
+//
+// Seeded generator for benchmark samples: the input distributions the sorts
+// are compared on, including an adversarial input for Partition().
+
+#include "workload.h"
+
+#include <stdexcept>
+#include <utility>
+#include "quicksort.h"
+
+/* SplitMix64, small and identical everywhere */
+class SplitMix {
+public:
+   explicit SplitMix(uint64_t seed) : state_(seed) {}
+
+   uint64_t Next() {
+      uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+   }
+
+   // Uniform in [0, bound) for bound > 0, close enough for benchmark inputs
+   uint64_t Below(uint64_t bound) { return Next() % bound; }
+
+private:
+   uint64_t state_;
+};
+
+/* McIlroy's adversary. Items start as "gas", which compares above every
+ fixed value. When two gas items meet, one is frozen at the next lowest value:
+ the one last compared against a fixed value if it is involved, since that is
+ the pivot the partition keeps comparing against. */
+class KillerAdversary {
+public:
+   explicit KillerAdversary(int size) : values_(size, size), gas_(size), solid_(0), candidate_(0) {}
+
+   bool Less(int x, int y) {
+      if (values_[x] == gas_ && values_[y] == gas_) {
+         Freeze(x == candidate_ ? x : y);
+      }
+      if (values_[x] == gas_) {
+         candidate_ = x;
+      }
+      else if (values_[y] == gas_) {
+         candidate_ = y;
+      }
+      return values_[x] < values_[y];
+   }
+
+   // Freeze what is left and return the value of every item
+   std::vector<int>& Values() {
+      for (int& value : values_) {
+         if (value == gas_) {
+            value = solid_++;
+         }
+      }
+      return values_;
+   }
+
+private:
+   void Freeze(int item) { values_[item] = solid_++; }
+
+   std::vector<int> values_;
+   int gas_;
+   int solid_;
+   int candidate_;
+};
+
+bool ParseDistribution(const std::string& name, Distribution& distribution) {
+   for (int dist = 0; dist < NUM_DISTRIBUTIONS; ++dist) {
+      if (name == DISTRIBUTION_NAMES[dist]) {
+         distribution = (Distribution)dist;
+         return true;
+      }
+   }
+   return false;
+}
+
+void GenerateSample(Distribution distribution, int size, uint64_t seed, const WorkloadOptions& options,
+                    std::vector<int>& sample) {
+   SplitMix rng(seed);
+   int period = 0;
+
+   sample.resize(size);
+   switch (distribution) {
+      case DIST_UNIFORM:
+         for (int& value : sample) {
+            value = (int)(uint32_t)rng.Next();
+         }
+         break;
+      case DIST_SORTED:
+         for (int pos = 0; pos < size; ++pos) {
+            sample[pos] = pos;
+         }
+         break;
+      case DIST_REVERSE:
+         for (int pos = 0; pos < size; ++pos) {
+            sample[pos] = size - 1 - pos;
+         }
+         break;
+      case DIST_NEARLY_SORTED:
+         for (int pos = 0; pos < size; ++pos) {
+            sample[pos] = pos;
+         }
+         for (int swap = 0; size > 0 && swap < options.swaps; ++swap) {
+            std::swap(sample[rng.Below(size)], sample[rng.Below(size)]);
+         }
+         break;
+      case DIST_FEW_UNIQUE:
+         for (int& value : sample) {
+            value = (int)rng.Below(std::max(options.uniqueValues, 1));
+         }
+         break;
+      case DIST_ORGAN_PIPE:
+         for (int pos = 0; pos < size; ++pos) {
+            sample[pos] = std::min(pos, size - 1 - pos);
+         }
+         break;
+      case DIST_SAWTOOTH:
+         period = std::max(size / std::max(options.sawtoothRuns, 1), 1);
+         for (int pos = 0; pos < size; ++pos) {
+            sample[pos] = pos % period;
+         }
+         break;
+      default: {
+         // Sort item ids with the adversary deciding every comparison, then
+         // give each position the value its item ended up with
+         KillerAdversary adversary(size);
+         std::vector<int> items(size);
+         NoCount counter;
+         for (int pos = 0; pos < size; ++pos) {
+            items[pos] = pos;
+         }
+         QuickSort(items.begin(), items.end(),
+                   [&adversary](int x, int y) { return adversary.Less(x, y); }, Identity(), counter);
+         sample = adversary.Values();
+         break;
+      }
+   }
+}
+
+uint64_t SampleSeed(uint64_t seed, int index) {
+   SplitMix rng(seed * 0xD1B54A32D192ED03ULL + index);
+   return rng.Next();
+}
+
+SampleJsonWriter::SampleJsonWriter() {
+}
+
+SampleJsonWriter::~SampleJsonWriter() {
+   if (output_.is_open()) {
+      try {
+         Close();
+      } catch (const std::exception&) {
+         // Nothing to report to from a destructor
+      }
+   }
+}
+
+void SampleJsonWriter::Open(const std::string& filename, int arraySize, int numSamples) {
+   filename_ = filename;
+   output_.open(filename, std::ios::trunc);
+   if (!output_.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+   }
+
+   output_ << "{\n"
+           << "    \"metadata\": {\n"
+           << "        \"arraySize\": " << arraySize << ",\n"
+           << "        \"numSamples\": " << numSamples << "\n"
+           << "    }";
+}
+
+void SampleJsonWriter::Add(const std::string& name, const int* data, size_t size) {
+   // Sample names come from the caller, escape what JSON requires
+   std::string escaped;
+   for (char c : name) {
+      if (c == '"' || c == '\\') {
+         escaped += '\\';
+      }
+      escaped += c;
+   }
+
+   output_ << ",\n    \"" << escaped << "\": [";
+   for (size_t pos = 0; pos < size; ++pos) {
+      output_ << (pos == 0 ? "\n        " : ",\n        ") << data[pos];
+   }
+   output_ << (size == 0 ? "]" : "\n    ]");
+
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
+
+void SampleJsonWriter::Close() {
+   output_ << "\n}\n";
+   output_.close();
+   if (!output_) {
+      throw std::runtime_error("Cannot write file: " + filename_);
+   }
+}
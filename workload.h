@@ -0,0 +1,72 @@
+// Workload
+//
+// Seeded generator for benchmark samples: the input distributions the sorts
+// are compared on, including an adversarial input for Partition().
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum Distribution {
+   DIST_UNIFORM,         // Any int, uniformly
+   DIST_SORTED,          // 0, 1, ..., n - 1
+   DIST_REVERSE,         // n - 1, ..., 1, 0
+   DIST_NEARLY_SORTED,   // Sorted, then `swaps` random pairs exchanged
+   DIST_FEW_UNIQUE,      // uniqueValues distinct values in random order
+   DIST_ORGAN_PIPE,      // 0, 1, ..., n / 2, ..., 1, 0
+   DIST_SAWTOOTH,        // sawtoothRuns ascending runs 0, 1, ..., n / sawtoothRuns - 1
+   DIST_KILLER,          // Quadratic input for the middle-pivot Partition()
+   NUM_DISTRIBUTIONS
+};
+
+const char* const DISTRIBUTION_NAMES[NUM_DISTRIBUTIONS] = {
+   "uniform", "sorted", "reverse", "nearlySorted", "fewUnique", "organPipe", "sawtooth", "killer"
+};
+
+struct WorkloadOptions {
+   int swaps = 16;          // Random swaps in a nearly sorted sample
+   int uniqueValues = 16;   // Distinct values in a few-unique sample
+   int sawtoothRuns = 8;    // Ascending runs in a sawtooth sample
+};
+
+// Look up a distribution by its DISTRIBUTION_NAMES entry, false if there is none
+bool ParseDistribution(const std::string& name, Distribution& distribution);
+
+/* Fill sample with size values from distribution. The same seed gives the
+ same sample on every platform: values come from a 64-bit SplitMix sequence
+ seeded with seed, never from the standard library distributions.
+
+ DIST_KILLER runs McIlroy's adversary ("A Killer Adversary for Quicksort")
+ against QuickSort(): values are only fixed when a comparison forces them, and
+ the one about to be the pivot is always fixed low. The result makes every
+ Partition() split off a constant number of elements, so it takes O(n^2)
+ time to generate and QuickSort() recurses about n levels deep on it. */
+void GenerateSample(Distribution distribution, int size, uint64_t seed, const WorkloadOptions& options,
+                    std::vector<int>& sample);
+
+/* Seed for sample number index of a set generated from seed. Seeds are
+ hashed, so neighbouring samples do not share shifted value sequences. */
+uint64_t SampleSeed(uint64_t seed, int index);
+
+/* Writes the JSON sample layout, {"metadata": {"arraySize", "numSamples"},
+ "<name>": [ints], ...}, one sample at a time and indented like the existing
+ sample files. Errors throw runtime_error. */
+class SampleJsonWriter {
+public:
+   SampleJsonWriter();
+   ~SampleJsonWriter();
+
+   void Open(const std::string& filename, int arraySize, int numSamples);
+   void Add(const std::string& name, const int* data, size_t size);
+   void Close();
+
+private:
+   std::string filename_;
+   std::ofstream output_;
+};
+
+#endif